@@ -28,13 +28,15 @@
 #include <qpushbutton.h>
 #include <qhbox.h>
 #include <qvbox.h>
-#include <qapplication.h>
 #include <vector>
 #include <qevent.h>
 
 // Plot a new point every PLOT_PERIOD Realtime periods.
 #define PLOT_PERIOD 100
 
+// Draw whatever the realtime thread has plotted every PLOT_DRAIN_MS.
+#define PLOT_DRAIN_MS 50
+
 // I think this is here to synchronize the parameters between the GUI thread, 
 // which might change them as a result of the user's changes, and the realtime 
 // thread, which might be executing an iteration of the plugin.
@@ -52,43 +54,16 @@ namespace
 
 
 // You don't want to do anything to the GUI from any thread except Qt's.
-// We'd normally use signals here, but (despite others' attempts) no dice.
-// Qt3 signals don't work cross-thread, so instead you have to use custom 
-// events. Here is a custom event class for plotting. When you want to change 
-// something with the plots, make an instance of this class and give it the 
-// changes you need, then have Qt hand it off to its main thread.
-// See the plot and customEvent methods below for how this is used.
-enum
-{
-  IHateThreadsEventSetAxes = 65445,
-  IHateThreadsEventAppendPoint = 65446,
-  IHateThreadsEventNewCurve = 65447,
-  IHateThreadsEventClear = 65448,
-};
+// Qt3 signals don't work cross-thread, and custom events mean a heap 
+// allocation and a lock on every plotted point. So instead, when the realtime 
+// thread wants to change something on the plots, it fills in a PlotCommand 
+// and pushes it onto plotQueue, a ring buffer that never allocates or blocks. 
+// The GUI thread drains the queue every PLOT_DRAIN_MS and applies the whole 
+// batch. If the GUI falls so far behind that the queue fills up, commands are 
+// dropped and counted in "Dropped plot commands". Changes to both plots at 
+// once go in together or not at all, so the two never disagree.
+// See the plot and drainPlotQueue methods below for how this is used.
 
-class IHateThreadsEvent : public QCustomEvent
-{
-public:
-  IHateThreadsEvent(double xmin, double xmax, double ymin, double ymax) : 
-    QCustomEvent(IHateThreadsEventSetAxes)
-  {
-    points[0] = xmin, points[1] = xmax;
-    points[2] = ymin, points[3] = ymax;
-  }
-  
-  IHateThreadsEvent(double x, double y) : 
-    QCustomEvent(IHateThreadsEventAppendPoint)
-  {
-    points[0] = x, points[1] = y;
-  }
-  
-  IHateThreadsEvent(bool newCurveOrClear) : 
-    QCustomEvent(newCurveOrClear ? IHateThreadsEventNewCurve : IHateThreadsEventClear)
-  {}
-  
-  double points[4];
-};
-     
 // RTXI calls this function to get an instance of this plugin. No
 // initialization is done here; it's all in the constructor or update method.
 extern "C" Plugin::Object *createRTXIPlugin(void)
@@ -168,6 +143,12 @@ static DefaultGUIModel::variable_t vars[] =
     "Amplifier signal factor",
     DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
   },
+  {
+    "Dropped plot commands",
+    "Plot updates lost because the GUI fell behind the protocol",
+    DefaultGUIModel::STATE,
+  },
+  EXECTIME_VARS
 };
 
 static size_t num_vars = sizeof(vars) / sizeof(DefaultGUIModel::variable_t);
@@ -189,7 +170,8 @@ Istep::Istep(void) :
   duty(50), 
   offset(0.0),
   factor(200.0),
-  periodsSincePlot(0)
+  periodsSincePlot(0),
+  droppedPlotCommands(0)
 {
   setCaption(QString::number(getID()) + " Istep");
   
@@ -295,6 +277,9 @@ Istep::Istep(void) :
 	iplot->setMinimumSize(400, 100);
 	rightLayout->addWidget(iplot, 1);
 	
+	vbatch.plot = vplot;
+	ibatch.plot = iplot;
+	
 	layout->addLayout(rightLayout);
 	layout->setResizeMode(QLayout::Minimum);
 	layout->setStretchFactor(leftLayout, 0);
@@ -308,11 +293,16 @@ Istep::Istep(void) :
 	QTimer *timer = new QTimer(this);
 	timer->start(1000);
 	QObject::connect(timer, SIGNAL(timeout(void)), this, SLOT(refresh(void)));
+	
+	// and plot refresh rate
+	startTimer(PLOT_DRAIN_MS);
 	show();
     
   stepSize = (Amax - Amin) / Nsteps;
   update(PERIOD);
   update(INIT);
+  setState("Dropped plot commands", droppedPlotCommands);
+  EXECTIME_INIT;
   refresh();
 }
 
@@ -325,6 +315,7 @@ Istep::~Istep(void) {}
 // convert to milliseconds.
 void Istep::execute(void)
 {
+  EXECTIME_SCOPE;
   V = input(0);
 
   Iout = offset;
@@ -472,7 +463,10 @@ void Istep::update(update_flags_t flag)
     setParameter("Delay (ms)", delay * 1000.0);
   }
   
-  // Set up plot
+  // Set up plot. Anything still queued belongs to the old one.
+  plotQueue.clear();
+  vbatch.x.clear(), vbatch.y.clear();
+  ibatch.x.clear(), ibatch.y.clear();
   iplot->removeData();
   iplot->setAxes(0, period * 1000.0, offset + Amin, offset + Amax);
 
@@ -497,82 +491,116 @@ void Istep::plot(double t, double V, double I)
   periodsSincePlot = 0;
 }
 
-// The following are wrappers around creating and sending that custom event 
-// class defined up top. This methods are called in the realtime thread.
+// The following are wrappers around queueing up the PlotCommands described 
+// up top. These methods are called in the realtime thread.
 void Istep::setVPlotRange(double xmin, double xmax, double ymin, double ymax)
 {
-  IHateThreadsEvent *pe = new IHateThreadsEvent(xmin, xmax, ymin, ymax);
-  pe->setData((void *)'V');
-  QApplication::postEvent(this, pe);
+  PlotCommand c = { PlotCommand::SetAxes, vplot, { xmin, xmax, ymin, ymax } };
+  queuePlotCommand(c);
 }
 
 void Istep::newVDataPoint(double newx, double newy)
 {
-  IHateThreadsEvent *pe = new IHateThreadsEvent(newx, newy);
-  pe->setData((void *)'V');
-  QApplication::postEvent(this, pe);
+  PlotCommand c = { PlotCommand::AppendPoint, vplot, { newx, newy } };
+  queuePlotCommand(c);
 }
 
 void Istep::setIPlotRange(double xmin, double xmax, double ymin, double ymax)
 {
-  IHateThreadsEvent *pe = new IHateThreadsEvent(xmin, xmax, ymin, ymax);
-  pe->setData((void *)'I');
-  QApplication::postEvent(this, pe);
+  PlotCommand c = { PlotCommand::SetAxes, iplot, { xmin, xmax, ymin, ymax } };
+  queuePlotCommand(c);
 }
 
 void Istep::newIDataPoint(double newx, double newy)
 {
-  IHateThreadsEvent *pe = new IHateThreadsEvent(newx, newy);
-  pe->setData((void *)'I');
-  QApplication::postEvent(this, pe);
+  PlotCommand c = { PlotCommand::AppendPoint, iplot, { newx, newy } };
+  queuePlotCommand(c);
 }
 
 void Istep::startNewCurve(void)
 {
-  IHateThreadsEvent *pe1 = new IHateThreadsEvent(true);
-  pe1->setData((void *)'V');
-  QApplication::postEvent(this, pe1);
-  IHateThreadsEvent *pe2 = new IHateThreadsEvent(true);
-  pe2->setData((void *)'I');
-  QApplication::postEvent(this, pe2);
+  PlotCommand v = { PlotCommand::NewCurve, vplot };
+  PlotCommand i = { PlotCommand::NewCurve, iplot };
+  queuePlotCommands(v, i);
 }
 
 void Istep::clearPlot(void)
 {
-  IHateThreadsEvent *pe1 = new IHateThreadsEvent(false);
-  pe1->setData((void *)'V');
-  QApplication::postEvent(this, pe1);
-  IHateThreadsEvent *pe2 = new IHateThreadsEvent(false);
-  pe2->setData((void *)'I');
-  QApplication::postEvent(this, pe2);
+  PlotCommand v = { PlotCommand::Clear, vplot };
+  PlotCommand i = { PlotCommand::Clear, iplot };
+  queuePlotCommands(v, i);
+}
+
+void Istep::queuePlotCommand(const PlotCommand &command)
+{
+  if (!plotQueue.push(command))
+    droppedPlotCommands++;
+}
+
+// The GUI thread only ever makes room, so if there's room for two now, both
+// pushes will succeed.
+void Istep::queuePlotCommands(const PlotCommand &first, 
+                              const PlotCommand &second)
+{
+  if (plotQueue.capacity() - plotQueue.size() < 2) {
+    droppedPlotCommands += 2;
+    return;
+  }
+  plotQueue.push(first);
+  plotQueue.push(second);
 }
 
-// Plot events are handled here, on the main thread.
-void Istep::customEvent(QCustomEvent *e)
+// Plot commands are handled here, on the main thread.
+void Istep::timerEvent(QTimerEvent *)
 {
-  IHateThreadsEvent *pe = (IHateThreadsEvent *)e;
-  IncrementalPlot *target = (long)e->data() == 'V' ? vplot : iplot;
-  switch (e->type())
+  drainPlotQueue();
+}
+
+// Apply everything queued since last time. Runs of points are collected and 
+// handed to each plot at once, so it draws them in one go.
+void Istep::drainPlotQueue(void)
+{
+  PlotCommand c;
+  while (plotQueue.pop(c))
   {
-  case IHateThreadsEventSetAxes:
-  target->setAxes(pe->points[0], pe->points[1], pe->points[2], pe->points[3]);
-  break;
-  
-  case IHateThreadsEventAppendPoint:
-  target->appendLine(pe->points[0], pe->points[1]);
-  break;
-  
-  case IHateThreadsEventNewCurve:
-  target->startNewCurve();
-  break;
-  
-  case IHateThreadsEventClear:
-  target->removeData();
-  break;
-  
-  default:
-  break;
+    PlotBatch &batch = c.plot == vplot ? vbatch : ibatch;
+    if (c.type == PlotCommand::AppendPoint)
+    {
+      batch.x.push_back(c.points[0]);
+      batch.y.push_back(c.points[1]);
+      continue;
+    }
+    
+    flushPlotBatch(batch);
+    switch (c.type)
+    {
+    case PlotCommand::SetAxes:
+    c.plot->setAxes(c.points[0], c.points[1], c.points[2], c.points[3]);
+    break;
+    
+    case PlotCommand::NewCurve:
+    c.plot->startNewCurve();
+    break;
+    
+    case PlotCommand::Clear:
+    c.plot->removeData();
+    break;
+    
+    default:
+    break;
+    }
   }
+  flushPlotBatch(vbatch);
+  flushPlotBatch(ibatch);
+}
+
+void Istep::flushPlotBatch(PlotBatch &batch)
+{
+  if (batch.x.empty())
+    return;
+  batch.plot->appendLines(&batch.x[0], &batch.y[0], batch.x.size());
+  batch.x.clear();
+  batch.y.clear();
 }
 
 // From here to the end it's entirely the same as DefaultGUIModel.
@@ -655,6 +683,24 @@ void Istep::setParameter(const QString &name, const QString value)
 	}
 }
 
+void Istep::setState(const QString &name, double &ref)
+{
+	std::map<QString, param_t>::iterator n = parameter.find(name);
+	if ((n != parameter.end()) && (n->second.type & STATE)) {
+		setData(Workspace::STATE, n->second.index, &ref);
+		n->second.edit->setText(QString::number(ref));
+	}
+}
+
+void Istep::setEvent(const QString &name, double &ref)
+{
+	std::map<QString, param_t>::iterator n = parameter.find(name);
+	if ((n != parameter.end()) && (n->second.type & EVENT)) {
+		setData(Workspace::EVENT, n->second.index, &ref);
+		n->second.edit->setText(QString::number(ref));
+	}
+}
+
 void Istep::pause(bool p) {
 	if (pauseButton->isOn() != p)
 		pauseButton->setDown(p);
@@ -39,6 +39,7 @@ parameters set by the user (the labels and text boxes on the left).
 #include "include/incrementalplot.h"
 #include <string>
 #include <map>
+#include <vector>
 #include <qobject.h>
 #include <qstring.h>
 #include <qwidget.h>
@@ -47,11 +48,14 @@ parameters set by the user (the labels and text boxes on the left).
 #include <workspace.h>
 #include <event.h>
 #include <default_gui_model.h>
+#include "../common/exectime.h"
+#include "../common/ringbuffer.h"
 
 using namespace std;
 
 class QLabel;
 class QPushButton;
+class QTimerEvent;
 
 class Istep : public QWidget, public RT::Thread, public Plugin::Object, public Workspace::Instance, public Event::Handler
 {
@@ -87,8 +91,6 @@ public:
   virtual ~Istep(void);
   virtual void update(update_flags_t flag);
   virtual void execute(void);
-  
-  void customEvent(QCustomEvent *e);
 
 public slots:
 
@@ -106,6 +108,7 @@ protected:
 	void setComment(const QString &name, const QString comment);
 	void setState(const QString &name, double &ref);
 	void setEvent(const QString &name, double &ref);
+	void timerEvent(QTimerEvent *e);
 
 private:
   #define EPS 1e-9
@@ -135,6 +138,29 @@ private:
   void startNewCurve(void);
   void clearPlot(void);
   
+  // One change to a plot, queued by the realtime thread for the GUI thread.
+  struct PlotCommand
+  {
+    enum Type { SetAxes, AppendPoint, NewCurve, Clear } type;
+    IncrementalPlot *plot;
+    double points[4];
+  };
+  #define PLOT_QUEUE_SIZE 4096
+  RingBuffer<PlotCommand, PLOT_QUEUE_SIZE> plotQueue;
+  double droppedPlotCommands;
+  void queuePlotCommand(const PlotCommand &command);
+  void queuePlotCommands(const PlotCommand &first, const PlotCommand &second);
+  
+  // Points taken off plotQueue, waiting to be drawn in one go.
+  struct PlotBatch
+  {
+    IncrementalPlot *plot;
+    std::vector<double> x, y;
+  };
+  PlotBatch vbatch, ibatch;
+  void drainPlotQueue(void);
+  void flushPlotBatch(PlotBatch &batch);
+  
   // QT components
 	QPushButton *pauseButton;
 	IncrementalPlot *vplot, *iplot;
@@ -153,4 +179,6 @@ private:
 	bool periodEventPaused;
 	mutable QString junk;
 	std::map<QString, param_t> parameter;
+
+  EXECTIME_DECLARE;
 };
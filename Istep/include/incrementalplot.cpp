@@ -12,11 +12,13 @@ CurveData::CurveData() :
 }
 
 void
-CurveData::append(double *x, double *y, int count)
+CurveData::append(const double *x, const double *y, int count)
 {
-  if ((uint)d_count + count >= size())
+  if (d_count + count >= size())
   {
     int newSize = d_count + d_count;
+    if (newSize <= d_count + count)
+      newSize = d_count + count + 1;
     d_x.resize(newSize);
     d_y.resize(newSize);
   }
@@ -68,18 +70,27 @@ IncrementalPlot::IncrementalPlot(QWidget *parent) :
 void
 IncrementalPlot::appendLine(double x, double y)
 {
+  appendLines(&x, &y, 1);
+}
+
+void
+IncrementalPlot::appendLines(const double *x, const double *y, int count)
+{
+  if (count <= 0)
+    return;
   if (curves.empty())
     startNewCurve();
   
   QwtPlotCurve *l_curve = curves.back();
-  l_data.append(&x, &y, 1);
+  l_data.append(x, y, count);
   l_curve->setRawData(l_data.x() + curCurveOffset, 
                       l_data.y() + curCurveOffset, 
                       l_data.count() - curCurveOffset);
 
+  // Draw just the new segments (and the one joining them to the old ones).
   const bool cacheMode = canvas()->testPaintAttribute(QwtPlotCanvas::PaintCached);
   canvas()->setPaintAttribute(QwtPlotCanvas::PaintCached, false);
-  int start = l_curve->dataSize() - 2;
+  int start = l_curve->dataSize() - count - 1;
   if (start < 0)
     start = 0;
   l_curve->draw(start, l_curve->dataSize() - 1);
@@ -23,7 +23,7 @@ public:
 
   CurveData();
 
-  void append(double *x, double *y, int count);
+  void append(const double *x, const double *y, int count);
 
   int count() const;
   int size() const;
@@ -43,6 +43,7 @@ class IncrementalPlot : public BasicPlot
 public:
   IncrementalPlot(QWidget *parent = NULL);
   void appendLine(double x, double y); // append a point to the current curve
+  void appendLines(const double *x, const double *y, int count); // ...or several
   void startNewCurve(void);
   void removeData(void); // clears all data and lines
 
@@ -0,0 +1,163 @@
+/*
+ * Offline execute() benchmark.
+ *
+ * Loads whichever plugin it was linked with through createRTXIPlugin(), just
+ * like RTXI's plugin loader, then calls its execute() back to back and
+ * reports how long each tick took. Inputs are fed a fixed test signal, and
+ * posted events and timers are delivered every few milliseconds of simulated
+ * time, standing in for the GUI thread.
+ *
+ * Usage: bench_<plugin> [-n ticks] [-t period_ns] [-p "name=value"]...
+ * Each -p overrides a parameter (or other saved setting, e.g. a filename) as
+ * if loaded from a workspace file, before the run starts.
+ */
+
+#include <rtxi_stub.h>
+
+#include <getopt.h>
+#include <stdint.h>
+#include <algorithm>
+
+extern "C" Plugin::Object *createRTXIPlugin(void);
+
+#define DEFAULT_TICKS 5000000
+#define DEFAULT_PERIOD_NS 50000
+#define WARMUP_TICKS 10000
+#define PUMP_PERIOD_MS 10.0
+#define SIGNAL_LENGTH 4096
+
+namespace
+{
+
+inline int64_t now_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Cost of the two clock reads that bracket every tick, so it can be taken
+// back out of the measurements.
+int64_t timer_overhead_ns()
+{
+  std::vector<int64_t> samples(100000);
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    int64_t t0 = now_ns();
+    samples[i] = now_ns() - t0;
+  }
+  std::nth_element(samples.begin(), samples.begin() + samples.size() / 2,
+                   samples.end());
+  return samples[samples.size() / 2];
+}
+
+uint32_t percentile(std::vector<uint32_t> &v, double p)
+{
+  size_t k = (size_t)(p * (v.size() - 1));
+  std::nth_element(v.begin(), v.begin() + k, v.end());
+  return v[k];
+}
+
+void usage(const char *argv0)
+{
+  fprintf(stderr, "usage: %s [-n ticks] [-t period_ns] [-p name=value]...\n",
+          argv0);
+  ::exit(1);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  long ticks = DEFAULT_TICKS;
+  long long period = DEFAULT_PERIOD_NS;
+  std::vector<std::string> overrides;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:t:p:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n': ticks = atol(optarg); break;
+      case 't': period = atoll(optarg); break;
+      case 'p': overrides.push_back(optarg); break;
+      default: usage(argv[0]);
+    }
+  }
+  if (ticks <= 0 || period <= 0)
+    usage(argv[0]);
+
+  RT::System::getInstance()->setPeriod(period);
+  Plugin::Object *plugin = createRTXIPlugin();
+  RT::Thread *thread = dynamic_cast<RT::Thread *>(plugin);
+  Workspace::Instance *block = dynamic_cast<Workspace::Instance *>(plugin);
+  if (!thread || !block)
+  {
+    fprintf(stderr, "plugin is not an RT::Thread and Workspace::Instance\n");
+    return 1;
+  }
+
+  if (!overrides.empty())
+  {
+    Settings::Object::State s = plugin->save();
+    for (size_t i = 0; i < overrides.size(); i++)
+    {
+      size_t eq = overrides[i].find('=');
+      if (eq == std::string::npos)
+        usage(argv[0]);
+      s.saveString(overrides[i].substr(0, eq), overrides[i].substr(eq + 1));
+    }
+    plugin->load(s);
+  }
+
+  // A few components and a little deterministic noise, so filters and
+  // thresholds see something that moves.
+  std::vector<double> signal(SIGNAL_LENGTH);
+  uint32_t lcg = 12345;
+  for (size_t i = 0; i < signal.size(); i++)
+  {
+    lcg = lcg * 1664525 + 1013904223;
+    signal[i] = 0.5 * sin(2.0 * M_PI * 7.0 * i / SIGNAL_LENGTH) +
+                0.2 * sin(2.0 * M_PI * 331.0 * i / SIGNAL_LENGTH) +
+                0.05 * ((double)lcg / 4294967296.0 - 0.5);
+  }
+  size_t inputs = block->getCount(IO::INPUT);
+
+  double periodMs = period * 1e-6;
+  long pumpEvery = std::max(1L, (long)(PUMP_PERIOD_MS / periodMs));
+  int64_t overhead = timer_overhead_ns();
+  std::vector<uint32_t> elapsed(ticks);
+
+  for (long i = -WARMUP_TICKS; i < ticks; i++)
+  {
+    for (size_t j = 0; j < inputs; j++)
+      block->setInputValue(j, signal[(i + j * 97) & (SIGNAL_LENGTH - 1)]);
+
+    int64_t t0 = now_ns();
+    thread->execute();
+    int64_t t1 = now_ns() - t0 - overhead;
+
+    if (i >= 0)
+      elapsed[i] = t1 > 0 ? (uint32_t)t1 : 0;
+    if (i % pumpEvery == 0)
+      qt_stub_pump((i + WARMUP_TICKS) * periodMs);
+  }
+
+  double total = 0.0;
+  for (long i = 0; i < ticks; i++)
+    total += elapsed[i];
+  uint32_t max = *std::max_element(elapsed.begin(), elapsed.end());
+  uint32_t p50 = percentile(elapsed, 0.50);
+  uint32_t p99 = percentile(elapsed, 0.99);
+
+  printf("%s: %ld ticks, %lld ns period\n",
+         block->IO::Block::getName().c_str(), ticks, period);
+  printf("  ns/tick: mean %.1f  p50 %u  p99 %u  max %u  "
+         "(%lld ns timer overhead removed)\n",
+         total / ticks, p50, p99, max, (long long)overhead);
+  for (size_t i = 0; i < block->getCount(Workspace::STATE); i++)
+    printf("  %s = %g\n", block->getName(Workspace::STATE, i).c_str(),
+           block->getValue(Workspace::STATE, i));
+
+  return 0;
+}
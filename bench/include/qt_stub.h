@@ -0,0 +1,443 @@
+/*
+ * Qt 3 stand-in for the offline benchmarks.
+ *
+ * Just enough of the Qt 3 API for the plugin sources to compile and run on a
+ * host without Qt. Widgets are inert boxes that remember their text; posted
+ * events are queued (under a mutex, like the real thing) and delivered when
+ * the bench driver calls qt_stub_pump(), which stands in for the GUI thread.
+ */
+
+#ifndef QT_STUB_H
+#define QT_STUB_H
+
+#include <stdlib.h>
+#include <string>
+#include <list>
+#include <pthread.h>
+
+#define QT_VERSION 0x030308
+
+// No moc here, so signals and slots are plain member functions.
+#define Q_OBJECT
+#define slots
+#define signals protected
+#define emit
+#define SIGNAL(a) "2" #a
+#define SLOT(a) "1" #a
+
+class QObject;
+class QWidget;
+class QEvent;
+
+class QCString
+{
+public:
+  QCString(const std::string &s) : str(s) {}
+  operator const char *() const { return str.c_str(); }
+  const char *data() const { return str.c_str(); }
+private:
+  std::string str;
+};
+
+class QString
+{
+public:
+  QString() {}
+  QString(const char *s) : str(s ? s : "") {}
+  QString(const std::string &s) : str(s) {}
+
+  static QString number(int n, int base = 10);
+  static QString number(unsigned int n, int base = 10);
+  static QString number(long n, int base = 10);
+  static QString number(unsigned long n, int base = 10);
+  static QString number(double n, char f = 'g', int prec = 6);
+
+  double toDouble(bool *ok = 0) const;
+  int toInt(bool *ok = 0, int base = 10) const;
+  unsigned int toUInt(bool *ok = 0, int base = 10) const;
+  long toLong(bool *ok = 0, int base = 10) const;
+
+  const char *latin1() const { return str.c_str(); }
+  const char *ascii() const { return str.c_str(); }
+  QCString utf8() const { return QCString(str); }
+  QCString local8Bit() const { return QCString(str); }
+  operator std::string() const { return str; }
+
+  bool isNull() const { return str.empty(); }
+  bool isEmpty() const { return str.empty(); }
+  unsigned int length() const { return str.size(); }
+
+  bool operator==(const QString &o) const { return str == o.str; }
+  bool operator!=(const QString &o) const { return str != o.str; }
+  bool operator<(const QString &o) const { return str < o.str; }
+  QString &operator+=(const QString &o) { str += o.str; return *this; }
+  QString operator+(const QString &o) const { return QString(str + o.str); }
+
+private:
+  std::string str;
+};
+
+inline QString operator+(const char *a, const QString &b)
+{
+  return QString(a) + b;
+}
+
+class QSize
+{
+public:
+  QSize() : w(-1), h(-1) {}
+  QSize(int aw, int ah) : w(aw), h(ah) {}
+  int width() const { return w; }
+  int height() const { return h; }
+private:
+  int w, h;
+};
+
+class QRect
+{
+public:
+  QRect() : x(0), y(0), w(0), h(0) {}
+  QRect(int ax, int ay, int aw, int ah) : x(ax), y(ay), w(aw), h(ah) {}
+  int width() const { return w; }
+  int height() const { return h; }
+  void setWidth(int aw) { w = aw; }
+  void setHeight(int ah) { h = ah; }
+private:
+  int x, y, w, h;
+};
+
+class QColor
+{
+public:
+  QColor() : r(0), g(0), b(0) {}
+  QColor(int ar, int ag, int ab) : r(ar), g(ag), b(ab) {}
+private:
+  int r, g, b;
+};
+
+class Qt
+{
+public:
+  static const QColor black, white, gray;
+  enum PenStyle { NoPen, SolidLine, DashLine, DotLine };
+  enum Orientation { Horizontal, Vertical };
+};
+
+class QPen
+{
+public:
+  QPen() {}
+  QPen(const QColor &c, unsigned int width = 0, Qt::PenStyle style = Qt::SolidLine)
+    : color(c), w(width), s(style) {}
+private:
+  QColor color;
+  unsigned int w;
+  Qt::PenStyle s;
+};
+
+class QBrush
+{
+public:
+  QBrush() {}
+  QBrush(const QColor &c) : color(c) {}
+private:
+  QColor color;
+};
+
+class QEvent : public Qt
+{
+public:
+  enum Type { None = 0, Timer = 1, User = 1000 };
+  QEvent(int aType) : t(aType) {}
+  virtual ~QEvent() {}
+  int type() const { return t; }
+private:
+  int t;
+};
+
+class QCustomEvent : public QEvent
+{
+public:
+  QCustomEvent(int aType, void *aData = 0) : QEvent(aType), d(aData) {}
+  void *data() const { return d; }
+  void setData(void *aData) { d = aData; }
+private:
+  void *d;
+};
+
+class QTimerEvent : public QEvent
+{
+public:
+  QTimerEvent(int anId) : QEvent(Timer), id(anId) {}
+  int timerId() const { return id; }
+private:
+  int id;
+};
+
+// Children are deleted with their parent, as in Qt.
+class QObject : public Qt
+{
+public:
+  QObject(QObject *parent = 0, const char *name = 0);
+  virtual ~QObject();
+
+  static bool connect(const QObject *sender, const char *signal,
+                      const QObject *receiver, const char *member);
+
+  virtual bool event(QEvent *e);
+  virtual bool eventFilter(QObject *, QEvent *) { return false; }
+
+  int startTimer(int interval);
+  void killTimer(int id);
+
+protected:
+  virtual void customEvent(QCustomEvent *) {}
+  virtual void timerEvent(QTimerEvent *) {}
+
+private:
+  QObject *parentObject;
+  std::list<QObject *> children;
+};
+
+class QWidget : public QObject
+{
+public:
+  QWidget(QWidget *parent = 0, const char *name = 0);
+  virtual ~QWidget() {}
+
+  void setCaption(const QString &c) { caption = c; }
+  void show() {}
+  void hide() {}
+  void setEnabled(bool) {}
+  QRect geometry() const { return rect; }
+  void setGeometry(const QRect &r) { rect = r; }
+  void setMinimumSize(int, int) {}
+  virtual QSize sizeHint() const { return QSize(); }
+
+private:
+  QString caption;
+  QRect rect;
+};
+
+class QFrame : public QWidget
+{
+public:
+  enum Shape { NoFrame = 0, Box = 1, Panel = 2 };
+  QFrame(QWidget *parent = 0) : QWidget(parent) {}
+  void setFrameStyle(int) {}
+  void setLineWidth(int) {}
+};
+
+class QLayout : public QObject
+{
+public:
+  enum ResizeMode { FreeResize, Minimum, Fixed, Auto };
+  QLayout(QObject *parent = 0) : QObject(parent) {}
+  void setResizeMode(ResizeMode) {}
+  void setSpacing(int) {}
+  void setMargin(int) {}
+};
+
+class QBoxLayout : public QLayout
+{
+public:
+  QBoxLayout(QObject *parent = 0) : QLayout(parent) {}
+  void addWidget(QWidget *, int stretch = 0, int alignment = 0) {}
+  void addLayout(QLayout *, int stretch = 0) {}
+  bool setStretchFactor(QWidget *, int) { return true; }
+  bool setStretchFactor(QLayout *, int) { return true; }
+};
+
+class QVBoxLayout : public QBoxLayout
+{
+public:
+  QVBoxLayout(QWidget *parent = 0) : QBoxLayout(parent) {}
+  QVBoxLayout(QLayout *parentLayout) : QBoxLayout(parentLayout) {}
+};
+
+class QHBoxLayout : public QBoxLayout
+{
+public:
+  QHBoxLayout(QWidget *parent = 0) : QBoxLayout(parent) {}
+  QHBoxLayout(QLayout *parentLayout) : QBoxLayout(parentLayout) {}
+};
+
+class QGridLayout : public QLayout
+{
+public:
+  QGridLayout(QWidget *parent, int, int) : QLayout(parent) {}
+  QGridLayout(QLayout *parentLayout, int, int) : QLayout(parentLayout) {}
+  void addWidget(QWidget *, int, int, int alignment = 0) {}
+};
+
+class QLabel : public QFrame
+{
+public:
+  QLabel(const QString &aText, QWidget *parent) : QFrame(parent), t(aText) {}
+  void setText(const QString &aText) { t = aText; }
+  QString text() const { return t; }
+private:
+  QString t;
+};
+
+class QValidator : public QObject
+{
+public:
+  QValidator(QObject *parent) : QObject(parent) {}
+};
+
+class QDoubleValidator : public QValidator
+{
+public:
+  QDoubleValidator(QObject *parent, const char *name = 0) : QValidator(parent) {}
+};
+
+class QIntValidator : public QValidator
+{
+public:
+  QIntValidator(QObject *parent, const char *name = 0) : QValidator(parent) {}
+  void setBottom(int) {}
+};
+
+class QLineEdit : public QFrame
+{
+public:
+  QLineEdit(QWidget *parent) : QFrame(parent), isEdited(false) {}
+  void setText(const QString &aText) { t = aText; isEdited = false; }
+  QString text() const { return t; }
+  void setValidator(const QValidator *) {}
+  void setReadOnly(bool) {}
+  void selectAll() { t = ""; }
+  void insert(const QString &s) { t += s; }
+  bool edited() const { return isEdited; }
+  void setEdited(bool on) { isEdited = on; }
+private:
+  QString t;
+  bool isEdited;
+};
+
+class QPushButton : public QWidget
+{
+public:
+  QPushButton(const QString &aText, QWidget *parent) :
+    QWidget(parent), on(false) {}
+  void setToggleButton(bool) {}
+  void setOn(bool enable) { on = enable; }
+  bool isOn() const { return on; }
+  void setDown(bool enable) { on = enable; }
+private:
+  bool on;
+};
+
+class QToolTip
+{
+public:
+  static void add(QWidget *, const QString &) {}
+};
+
+class QScrollView : public QFrame
+{
+public:
+  enum ResizePolicy { Default, Manual, AutoOne, AutoOneFit };
+  enum ScrollBarMode { Auto, AlwaysOff, AlwaysOn };
+  QScrollView(QWidget *parent) : QFrame(parent), port(new QWidget(this)) {}
+  void setResizePolicy(ResizePolicy) {}
+  void setHScrollBarMode(ScrollBarMode) {}
+  void setVScrollBarMode(ScrollBarMode) {}
+  QWidget *viewport() const { return port; }
+  void addChild(QWidget *, int x = 0, int y = 0) {}
+private:
+  QWidget *port;
+};
+
+class QHBox : public QFrame
+{
+public:
+  QHBox(QWidget *parent) : QFrame(parent) {}
+};
+
+class QVBox : public QFrame
+{
+public:
+  QVBox(QWidget *parent) : QFrame(parent) {}
+};
+
+class QDialog : public QWidget
+{
+public:
+  enum DialogCode { Rejected, Accepted };
+  QDialog(QWidget *parent = 0) : QWidget(parent) {}
+  int exec() { return Rejected; }
+};
+
+class QFileDialog : public QDialog
+{
+public:
+  enum Mode { AnyFile, ExistingFile, Directory, ExistingFiles };
+  enum ViewMode { Detail, List };
+  QFileDialog(QWidget *parent, const char *name = 0, bool modal = false) :
+    QDialog(parent) {}
+  void setMode(Mode) {}
+  void setViewMode(ViewMode) {}
+  QString selectedFile() const { return QString(); }
+};
+
+class QTimer : public QObject
+{
+public:
+  QTimer(QObject *parent = 0) : QObject(parent) {}
+  int start(int msec, bool singleShot = false) { return 0; }
+  void stop() {}
+};
+
+// A real thread, so workers run alongside the benchmark loop.
+class QThread : public Qt
+{
+public:
+  QThread();
+  virtual ~QThread();
+  void start();
+  bool wait(unsigned long time = ~0UL);
+  void terminate();
+  bool finished() const;
+  bool running() const;
+  virtual void run() = 0;
+
+protected:
+  static void sleep(unsigned long secs);
+  static void msleep(unsigned long msecs);
+  static void usleep(unsigned long usecs);
+
+private:
+  static void *start_routine(void *thread);
+  pthread_t thread;
+  volatile bool isRunning, isStarted;
+};
+
+class QSemaphore
+{
+public:
+  QSemaphore(int maxcount);
+  virtual ~QSemaphore();
+  int operator++(int);
+  int operator--(int);
+  int available() const;
+  int total() const { return max; }
+private:
+  mutable pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int value, max;
+};
+
+class QApplication : public QObject
+{
+public:
+  static void postEvent(QObject *receiver, QEvent *event);
+  static void sendPostedEvents();
+};
+
+// Deliver posted events and any timers due by |nowMs| on the calling thread.
+// The bench driver calls this between ticks as the GUI thread's stand-in.
+void qt_stub_pump(double nowMs);
+
+#endif /* end of include guard: QT_STUB_H */
@@ -0,0 +1,2 @@
+// Offline benchmark stand-in; see qt_stub.h.
+#include <qt_stub.h>
@@ -0,0 +1,2 @@
+// Offline benchmark stand-in; see qwt_stub.h.
+#include <qwt_stub.h>
@@ -0,0 +1,116 @@
+/*
+ * Qwt (Qt 3 flavour) stand-in for the offline benchmarks.
+ *
+ * Plots accept data and axis changes and draw nothing, so Istep's plotting
+ * code runs as usual on the bench's stand-in GUI thread.
+ */
+
+#ifndef QWT_STUB_H
+#define QWT_STUB_H
+
+#include <vector>
+
+#include <qt_stub.h>
+
+template <typename T>
+class QwtArray
+{
+public:
+  QwtArray(int size = 0) : d(size) {}
+  void resize(int size) { d.resize(size); }
+  unsigned int size() const { return d.size(); }
+  T &operator[](int i) { return d[i]; }
+  const T &operator[](int i) const { return d[i]; }
+  const T *data() const { return d.empty() ? 0 : &d[0]; }
+private:
+  std::vector<T> d;
+};
+
+class QwtScaleDiv;
+class QwtScaleDraw;
+class QwtScaleWidget;
+
+class QwtSymbol
+{
+public:
+  enum Style { NoSymbol = -1, Ellipse, Rect };
+  QwtSymbol() {}
+  QwtSymbol(Style, const QBrush &, const QPen &, const QSize &) {}
+};
+
+class QwtPlotCanvas : public QFrame
+{
+public:
+  enum PaintAttribute { PaintCached = 1, PaintPacked = 2 };
+  QwtPlotCanvas(QWidget *parent) : QFrame(parent), attributes(0) {}
+  bool testPaintAttribute(PaintAttribute a) const { return attributes & a; }
+  void setPaintAttribute(PaintAttribute a, bool on = true)
+  {
+    attributes = on ? (attributes | a) : (attributes & ~a);
+  }
+private:
+  int attributes;
+};
+
+class QwtPlotLayout
+{
+public:
+  void setAlignCanvasToScales(bool) {}
+};
+
+class QwtPlot : public QFrame
+{
+public:
+  enum Axis { yLeft, yRight, xBottom, xTop, axisCnt };
+  QwtPlot(QWidget *parent = 0) : QFrame(parent), c(new QwtPlotCanvas(this)) {}
+  void setAutoReplot(bool) {}
+  QwtPlotCanvas *canvas() { return c; }
+  QwtPlotLayout *plotLayout() { return &layout; }
+  void replot() {}
+  void setAxisTitle(int, const QString &) {}
+  void setAxisScale(int, double, double, double step = 0) {}
+  void setCanvasLineWidth(int) {}
+  void setCanvasBackground(const QColor &) {}
+private:
+  QwtPlotCanvas *c;
+  QwtPlotLayout layout;
+};
+
+class QwtPlotItem
+{
+public:
+  virtual ~QwtPlotItem() {}
+  void attach(QwtPlot *) {}
+};
+
+class QwtPlotCurve : public QwtPlotItem
+{
+public:
+  enum CurveStyle { NoCurve, Lines, Sticks, Steps, Dots };
+  enum PaintAttribute { PaintFiltered = 1 };
+  QwtPlotCurve(const QString &) : n(0) {}
+  void setStyle(CurveStyle) {}
+  void setPaintAttribute(PaintAttribute, bool on = true) {}
+  void setPen(const QPen &) {}
+  void setSymbol(const QwtSymbol &) {}
+  void setRawData(const double *, const double *, int size) { n = size; }
+  int dataSize() const { return n; }
+  void draw(int, int) const {}
+private:
+  int n;
+};
+
+class QwtPlotGrid : public QwtPlotItem
+{
+public:
+  void setMajPen(const QPen &) {}
+};
+
+class QwtPlotZoomer : public QObject
+{
+public:
+  QwtPlotZoomer(QwtPlotCanvas *canvas) : QObject(canvas) {}
+  virtual void rescale() {}
+};
+
+#endif /* end of include guard: QWT_STUB_H */
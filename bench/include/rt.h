@@ -0,0 +1,2 @@
+// Offline benchmark stand-in; see rtxi_stub.h.
+#include <rtxi_stub.h>
@@ -0,0 +1,309 @@
+/*
+ * RTXI stand-in for the offline benchmarks.
+ *
+ * Mirrors the parts of the RTXI 1.x headers the plugins use: IO::Block and
+ * its input()/output() accessors, Workspace::Instance, RT::System and
+ * RT::Thread, Plugin::Object, Settings::Object, Event::Handler and
+ * DefaultGUIModel. There is no realtime thread; the bench driver calls
+ * execute() itself and sets inputs with IO::Block::setInputValue().
+ */
+
+#ifndef RTXI_STUB_H
+#define RTXI_STUB_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <qt_stub.h>
+
+#define ERROR_MSG(fmt, args...) fprintf(stderr, fmt, ## args)
+#define DEBUG_MSG(fmt, args...)
+
+namespace IO
+{
+typedef unsigned long flags_t;
+static const flags_t INPUT = 0x1;
+static const flags_t OUTPUT = 0x2;
+
+struct channel_t
+{
+  std::string name;
+  std::string description;
+  flags_t flags;
+};
+
+class Block
+{
+public:
+  Block(std::string name, channel_t *channels, size_t size);
+  virtual ~Block();
+
+  std::string getName() const { return name; }
+  size_t getCount(flags_t type) const;
+  std::string getName(flags_t type, size_t index) const;
+  double getValue(flags_t type, size_t index) const;
+
+  double input(size_t index) const;
+  double &output(size_t index);
+
+  // Bench driver's replacement for a connected upstream block.
+  void setInputValue(size_t index, double value);
+
+private:
+  std::string name;
+  std::vector<std::string> inputNames, outputNames;
+  std::vector<double> inputs, outputs;
+};
+}
+
+namespace Workspace
+{
+static const IO::flags_t INPUT = IO::INPUT;
+static const IO::flags_t OUTPUT = IO::OUTPUT;
+static const IO::flags_t PARAMETER = IO::OUTPUT << 1;
+static const IO::flags_t STATE = IO::OUTPUT << 2;
+static const IO::flags_t EVENT = IO::OUTPUT << 3;
+static const IO::flags_t COMMENT = IO::OUTPUT << 4;
+
+typedef IO::channel_t variable_t;
+
+class Instance : public IO::Block
+{
+public:
+  Instance(std::string name, variable_t *variables, size_t size);
+  virtual ~Instance();
+
+  size_t getCount(IO::flags_t type) const;
+  std::string getName(IO::flags_t type, size_t index) const;
+  double getValue(IO::flags_t type, size_t index) const;
+  std::string getValueString(IO::flags_t type, size_t index) const;
+  void setValue(size_t index, double value);
+  void setComment(size_t index, std::string comment);
+
+protected:
+  void setData(IO::flags_t type, size_t index, double *data);
+  double *getData(IO::flags_t type, size_t index);
+
+private:
+  struct var_t
+  {
+    std::string name;
+    double value;
+    double *data;
+    std::string comment;
+  };
+  std::vector<var_t> parameters, states, events, comments;
+  std::vector<var_t> *listFor(IO::flags_t type);
+  const std::vector<var_t> *listFor(IO::flags_t type) const;
+};
+}
+
+namespace RT
+{
+class Event
+{
+public:
+  Event() {}
+  virtual ~Event() {}
+  virtual int callback() = 0;
+};
+
+class Thread
+{
+public:
+  typedef unsigned long Priority;
+  static const Priority DefaultPriority = 0;
+
+  Thread(Priority p = DefaultPriority) : active(false) {}
+  virtual ~Thread() {}
+
+  bool getActive() const { return active; }
+  void setActive(bool state) { active = state; }
+  virtual void execute() {}
+
+private:
+  bool active;
+};
+
+class System
+{
+public:
+  static System *getInstance();
+  long long getPeriod() const { return period; }
+  int setPeriod(long long ns) { period = ns; return 0; }
+  // There is no realtime thread to synchronize with, so run it here.
+  int postEvent(Event *event, bool blocking = true)
+  {
+    return event->callback();
+  }
+
+private:
+  System() : period(50000) {}
+  long long period;
+};
+}
+
+namespace Settings
+{
+class Object
+{
+public:
+  typedef unsigned long ID;
+
+  class State
+  {
+  public:
+    std::string loadString(const std::string &name) const;
+    void saveString(const std::string &name, const std::string &value);
+    int loadInteger(const std::string &name) const;
+    void saveInteger(const std::string &name, int value);
+    double loadDouble(const std::string &name) const;
+    void saveDouble(const std::string &name, double value);
+  private:
+    std::map<std::string, std::string> values;
+  };
+
+  Object();
+  virtual ~Object() {}
+  ID getID() const { return id; }
+  State save() const;
+  void load(const State &s);
+
+protected:
+  virtual void doLoad(const State &) {}
+  virtual void doSave(State &) const {}
+
+private:
+  ID id;
+};
+}
+
+namespace Plugin
+{
+class Object : public Settings::Object
+{
+public:
+  Object() {}
+  virtual ~Object() {}
+  void unload();
+};
+
+class Manager
+{
+public:
+  static Manager *getInstance();
+  void unload(Object *object);
+};
+}
+
+namespace Event
+{
+extern const char *RT_PREPERIOD_EVENT;
+extern const char *RT_POSTPERIOD_EVENT;
+
+class Object
+{
+public:
+  Object(const char *aName) : name(aName) {}
+  const char *getName() const { return name; }
+private:
+  const char *name;
+};
+
+class Handler
+{
+public:
+  Handler() {}
+  virtual ~Handler() {}
+  virtual void receiveEvent(const Object *) {}
+};
+}
+
+class MainWindow : public QWidget
+{
+public:
+  static MainWindow *getInstance();
+  QWidget *centralWidget() { return this; }
+};
+
+class DefaultGUILineEdit : public QLineEdit
+{
+public:
+  DefaultGUILineEdit(QWidget *parent) : QLineEdit(parent) {}
+  void blacken() { setEdited(false); }
+  void redden() { setEdited(true); }
+};
+
+class DefaultGUIModel : public QWidget,
+                        public RT::Thread,
+                        public Plugin::Object,
+                        public Workspace::Instance,
+                        public Event::Handler
+{
+public:
+  static const IO::flags_t INPUT = Workspace::INPUT;
+  static const IO::flags_t OUTPUT = Workspace::OUTPUT;
+  static const IO::flags_t PARAMETER = Workspace::PARAMETER;
+  static const IO::flags_t STATE = Workspace::STATE;
+  static const IO::flags_t EVENT = Workspace::EVENT;
+  static const IO::flags_t COMMENT = Workspace::COMMENT;
+  static const IO::flags_t DOUBLE = Workspace::COMMENT << 1;
+  static const IO::flags_t INTEGER = Workspace::COMMENT << 2;
+  static const IO::flags_t UINTEGER = Workspace::COMMENT << 3;
+  typedef Workspace::variable_t variable_t;
+
+  enum update_flags_t
+  {
+    INIT,
+    MODIFY,
+    PERIOD,
+    PAUSE,
+    UNPAUSE,
+    EXIT,
+  };
+
+  DefaultGUIModel(std::string name, variable_t *variables, size_t size);
+  virtual ~DefaultGUIModel();
+
+public slots:
+  void exit();
+  void refresh();
+  void modify();
+  void pause(bool);
+
+protected:
+  virtual void update(update_flags_t flag) {}
+
+  QString getParameter(const QString &name);
+  void setParameter(const QString &name, double value);
+  void setParameter(const QString &name, const QString value);
+  QString getComment(const QString &name);
+  void setComment(const QString &name, const QString comment);
+  void setState(const QString &name, double &ref);
+  void setEvent(const QString &name, double &ref);
+
+private:
+  void doLoad(const Settings::Object::State &);
+  void doSave(Settings::Object::State &) const;
+  void receiveEvent(const ::Event::Object *);
+
+  struct param_t
+  {
+    QLabel *label;
+    DefaultGUILineEdit *edit;
+    IO::flags_t type;
+    size_t index;
+    QString *str_value;
+  };
+  bool paused;
+  bool periodEventPaused;
+  std::map<QString, param_t> parameter;
+};
+
+#endif /* end of include guard: RTXI_STUB_H */
@@ -0,0 +1,304 @@
+/*
+ * Qt 3 stand-in for the offline benchmarks. See include/qt_stub.h.
+ */
+
+#include <qt_stub.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <time.h>
+#include <deque>
+#include <utility>
+
+const QColor Qt::black(0, 0, 0);
+const QColor Qt::white(255, 255, 255);
+const QColor Qt::gray(160, 160, 164);
+
+QString QString::number(int n, int base)
+{
+  return number((long)n, base);
+}
+
+QString QString::number(unsigned int n, int base)
+{
+  return number((unsigned long)n, base);
+}
+
+QString QString::number(long n, int base)
+{
+  char buf[32];
+  snprintf(buf, sizeof(buf), base == 16 ? "%lx" : "%ld", n);
+  return QString(buf);
+}
+
+QString QString::number(unsigned long n, int base)
+{
+  char buf[32];
+  snprintf(buf, sizeof(buf), base == 16 ? "%lx" : "%lu", n);
+  return QString(buf);
+}
+
+QString QString::number(double n, char f, int prec)
+{
+  char format[8], buf[64];
+  snprintf(format, sizeof(format), "%%.%d%c", prec, f);
+  snprintf(buf, sizeof(buf), format, n);
+  return QString(buf);
+}
+
+double QString::toDouble(bool *ok) const
+{
+  char *end;
+  double value = strtod(str.c_str(), &end);
+  if (ok)
+    *ok = !str.empty() && *end == '\0';
+  return value;
+}
+
+long QString::toLong(bool *ok, int base) const
+{
+  char *end;
+  long value = strtol(str.c_str(), &end, base);
+  if (ok)
+    *ok = !str.empty() && *end == '\0';
+  return value;
+}
+
+int QString::toInt(bool *ok, int base) const
+{
+  return (int)toLong(ok, base);
+}
+
+unsigned int QString::toUInt(bool *ok, int base) const
+{
+  char *end;
+  unsigned long value = strtoul(str.c_str(), &end, base);
+  if (ok)
+    *ok = !str.empty() && *end == '\0';
+  return (unsigned int)value;
+}
+
+namespace
+{
+pthread_mutex_t postedMutex = PTHREAD_MUTEX_INITIALIZER;
+std::deque<std::pair<QObject *, QEvent *> > posted;
+
+struct timer_t_
+{
+  QObject *receiver;
+  int id;
+  double interval, due;
+};
+std::list<timer_t_> timers;
+int nextTimerId = 1;
+double lastNow = 0.0;
+}
+
+QObject::QObject(QObject *parent, const char *) : parentObject(parent)
+{
+  if (parentObject)
+    parentObject->children.push_back(this);
+}
+
+QObject::~QObject()
+{
+  while (!children.empty())
+  {
+    QObject *child = children.front();
+    children.pop_front();
+    child->parentObject = 0;
+    delete child;
+  }
+  if (parentObject)
+    parentObject->children.remove(this);
+  for (std::list<timer_t_>::iterator i = timers.begin(); i != timers.end(); )
+  {
+    if (i->receiver == this)
+      i = timers.erase(i);
+    else
+      ++i;
+  }
+}
+
+bool QObject::connect(const QObject *, const char *, const QObject *,
+                      const char *)
+{
+  return true;
+}
+
+bool QObject::event(QEvent *e)
+{
+  if (e->type() == QEvent::Timer)
+    timerEvent((QTimerEvent *)e);
+  else if (e->type() >= QEvent::User)
+    customEvent((QCustomEvent *)e);
+  return true;
+}
+
+int QObject::startTimer(int interval)
+{
+  timer_t_ t = { this, nextTimerId++, (double)interval, lastNow + interval };
+  timers.push_back(t);
+  return t.id;
+}
+
+void QObject::killTimer(int id)
+{
+  for (std::list<timer_t_>::iterator i = timers.begin(); i != timers.end(); ++i)
+  {
+    if (i->id == id)
+    {
+      timers.erase(i);
+      return;
+    }
+  }
+}
+
+QWidget::QWidget(QWidget *parent, const char *name) : QObject(parent, name) {}
+
+QThread::QThread() : isRunning(false), isStarted(false) {}
+
+QThread::~QThread() {}
+
+void *QThread::start_routine(void *thread)
+{
+  QThread *self = (QThread *)thread;
+  self->run();
+  self->isRunning = false;
+  return NULL;
+}
+
+void QThread::start()
+{
+  isRunning = isStarted = true;
+  pthread_create(&thread, NULL, start_routine, this);
+}
+
+bool QThread::wait(unsigned long)
+{
+  if (isStarted)
+  {
+    pthread_join(thread, NULL);
+    isStarted = isRunning = false;
+  }
+  return true;
+}
+
+void QThread::terminate()
+{
+  if (isStarted && isRunning)
+    pthread_cancel(thread);
+}
+
+bool QThread::finished() const
+{
+  return isStarted && !isRunning;
+}
+
+bool QThread::running() const
+{
+  return isRunning;
+}
+
+void QThread::sleep(unsigned long secs)
+{
+  usleep(secs * 1000000);
+}
+
+void QThread::msleep(unsigned long msecs)
+{
+  usleep(msecs * 1000);
+}
+
+void QThread::usleep(unsigned long usecs)
+{
+  struct timespec ts;
+  ts.tv_sec = usecs / 1000000;
+  ts.tv_nsec = (usecs % 1000000) * 1000;
+  while (nanosleep(&ts, &ts) == -1 && errno == EINTR)
+    ;
+}
+
+// Qt 3 semantics: ++ takes one of |maxcount| slots, blocking while none are
+// free; -- gives one back.
+QSemaphore::QSemaphore(int maxcount) : value(0), max(maxcount)
+{
+  pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&cond, NULL);
+}
+
+QSemaphore::~QSemaphore()
+{
+  pthread_cond_destroy(&cond);
+  pthread_mutex_destroy(&mutex);
+}
+
+int QSemaphore::operator++(int)
+{
+  pthread_mutex_lock(&mutex);
+  while (value >= max)
+    pthread_cond_wait(&cond, &mutex);
+  int result = ++value;
+  pthread_mutex_unlock(&mutex);
+  return result;
+}
+
+int QSemaphore::operator--(int)
+{
+  pthread_mutex_lock(&mutex);
+  if (value > 0)
+    value--;
+  int result = value;
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mutex);
+  return result;
+}
+
+int QSemaphore::available() const
+{
+  pthread_mutex_lock(&mutex);
+  int result = max - value;
+  pthread_mutex_unlock(&mutex);
+  return result;
+}
+
+void QApplication::postEvent(QObject *receiver, QEvent *event)
+{
+  pthread_mutex_lock(&postedMutex);
+  posted.push_back(std::make_pair(receiver, event));
+  pthread_mutex_unlock(&postedMutex);
+}
+
+void QApplication::sendPostedEvents()
+{
+  std::deque<std::pair<QObject *, QEvent *> > batch;
+  pthread_mutex_lock(&postedMutex);
+  batch.swap(posted);
+  pthread_mutex_unlock(&postedMutex);
+  for (size_t i = 0; i < batch.size(); i++)
+  {
+    batch[i].first->event(batch[i].second);
+    delete batch[i].second;
+  }
+}
+
+void qt_stub_pump(double nowMs)
+{
+  lastNow = nowMs;
+  QApplication::sendPostedEvents();
+  // Timer handlers may start or kill timers, so fire from a snapshot.
+  std::list<timer_t_> due;
+  for (std::list<timer_t_>::iterator i = timers.begin(); i != timers.end(); ++i)
+  {
+    if (i->due <= nowMs)
+    {
+      i->due = nowMs + i->interval;
+      due.push_back(*i);
+    }
+  }
+  for (std::list<timer_t_>::iterator i = due.begin(); i != due.end(); ++i)
+  {
+    QTimerEvent e(i->id);
+    i->receiver->event(&e);
+  }
+}
@@ -0,0 +1,444 @@
+/*
+ * RTXI stand-in for the offline benchmarks. See include/rtxi_stub.h.
+ */
+
+#include <rtxi_stub.h>
+
+const char *Event::RT_PREPERIOD_EVENT = "SYSTEM : pre period";
+const char *Event::RT_POSTPERIOD_EVENT = "SYSTEM : post period";
+
+IO::Block::Block(std::string aName, channel_t *channels, size_t size) :
+  name(aName)
+{
+  for (size_t i = 0; i < size; i++)
+  {
+    if (channels[i].flags & INPUT)
+      inputNames.push_back(channels[i].name);
+    else if (channels[i].flags & OUTPUT)
+      outputNames.push_back(channels[i].name);
+  }
+  inputs.resize(inputNames.size(), 0.0);
+  outputs.resize(outputNames.size(), 0.0);
+}
+
+IO::Block::~Block() {}
+
+size_t IO::Block::getCount(flags_t type) const
+{
+  if (type & INPUT)
+    return inputs.size();
+  if (type & OUTPUT)
+    return outputs.size();
+  return 0;
+}
+
+std::string IO::Block::getName(flags_t type, size_t index) const
+{
+  if ((type & INPUT) && index < inputNames.size())
+    return inputNames[index];
+  if ((type & OUTPUT) && index < outputNames.size())
+    return outputNames[index];
+  return "";
+}
+
+double IO::Block::getValue(flags_t type, size_t index) const
+{
+  if ((type & INPUT) && index < inputs.size())
+    return inputs[index];
+  if ((type & OUTPUT) && index < outputs.size())
+    return outputs[index];
+  return 0.0;
+}
+
+// Out of line, like the real accessors, so the call cost is comparable.
+double IO::Block::input(size_t index) const
+{
+  return inputs[index];
+}
+
+double &IO::Block::output(size_t index)
+{
+  return outputs[index];
+}
+
+void IO::Block::setInputValue(size_t index, double value)
+{
+  if (index < inputs.size())
+    inputs[index] = value;
+}
+
+Workspace::Instance::Instance(std::string name, variable_t *variables,
+                              size_t size) :
+  IO::Block(name, variables, size)
+{
+  for (size_t i = 0; i < size; i++)
+  {
+    std::vector<var_t> *list = listFor(variables[i].flags);
+    if (list)
+    {
+      var_t var = { variables[i].name, 0.0, NULL, "" };
+      list->push_back(var);
+    }
+  }
+}
+
+Workspace::Instance::~Instance() {}
+
+std::vector<Workspace::Instance::var_t> *
+Workspace::Instance::listFor(IO::flags_t type)
+{
+  if (type & PARAMETER)
+    return &parameters;
+  if (type & STATE)
+    return &states;
+  if (type & EVENT)
+    return &events;
+  if (type & COMMENT)
+    return &comments;
+  return NULL;
+}
+
+const std::vector<Workspace::Instance::var_t> *
+Workspace::Instance::listFor(IO::flags_t type) const
+{
+  return const_cast<Instance *>(this)->listFor(type);
+}
+
+size_t Workspace::Instance::getCount(IO::flags_t type) const
+{
+  const std::vector<var_t> *list = listFor(type);
+  return list ? list->size() : IO::Block::getCount(type);
+}
+
+std::string Workspace::Instance::getName(IO::flags_t type, size_t index) const
+{
+  const std::vector<var_t> *list = listFor(type);
+  if (!list)
+    return IO::Block::getName(type, index);
+  return index < list->size() ? (*list)[index].name : "";
+}
+
+double Workspace::Instance::getValue(IO::flags_t type, size_t index) const
+{
+  const std::vector<var_t> *list = listFor(type);
+  if (!list)
+    return IO::Block::getValue(type, index);
+  if (index >= list->size())
+    return 0.0;
+  const var_t &var = (*list)[index];
+  return var.data ? *var.data : var.value;
+}
+
+std::string Workspace::Instance::getValueString(IO::flags_t type,
+                                                size_t index) const
+{
+  if ((type & COMMENT) && index < comments.size())
+    return comments[index].comment;
+  return "";
+}
+
+void Workspace::Instance::setValue(size_t index, double value)
+{
+  if (index < parameters.size())
+    parameters[index].value = value;
+}
+
+void Workspace::Instance::setComment(size_t index, std::string comment)
+{
+  if (index < comments.size())
+    comments[index].comment = comment;
+}
+
+void Workspace::Instance::setData(IO::flags_t type, size_t index, double *data)
+{
+  std::vector<var_t> *list = listFor(type);
+  if (list && index < list->size())
+    (*list)[index].data = data;
+}
+
+double *Workspace::Instance::getData(IO::flags_t type, size_t index)
+{
+  std::vector<var_t> *list = listFor(type);
+  if (list && index < list->size())
+    return (*list)[index].data;
+  return NULL;
+}
+
+RT::System *RT::System::getInstance()
+{
+  static System instance;
+  return &instance;
+}
+
+std::string Settings::Object::State::loadString(const std::string &name) const
+{
+  std::map<std::string, std::string>::const_iterator i = values.find(name);
+  return i == values.end() ? "" : i->second;
+}
+
+void Settings::Object::State::saveString(const std::string &name,
+                                         const std::string &value)
+{
+  values[name] = value;
+}
+
+int Settings::Object::State::loadInteger(const std::string &name) const
+{
+  return atoi(loadString(name).c_str());
+}
+
+void Settings::Object::State::saveInteger(const std::string &name, int value)
+{
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%d", value);
+  values[name] = buf;
+}
+
+double Settings::Object::State::loadDouble(const std::string &name) const
+{
+  return strtod(loadString(name).c_str(), NULL);
+}
+
+void Settings::Object::State::saveDouble(const std::string &name, double value)
+{
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.17g", value);
+  values[name] = buf;
+}
+
+Settings::Object::Object()
+{
+  static ID nextID = 1;
+  id = nextID++;
+}
+
+Settings::Object::State Settings::Object::save() const
+{
+  State s;
+  doSave(s);
+  return s;
+}
+
+void Settings::Object::load(const State &s)
+{
+  doLoad(s);
+}
+
+void Plugin::Object::unload()
+{
+  Manager::getInstance()->unload(this);
+}
+
+Plugin::Manager *Plugin::Manager::getInstance()
+{
+  static Manager instance;
+  return &instance;
+}
+
+void Plugin::Manager::unload(Object *object)
+{
+  delete object;
+}
+
+MainWindow *MainWindow::getInstance()
+{
+  static MainWindow instance;
+  return &instance;
+}
+
+// The rest follows RTXI's DefaultGUIModel, minus the widgets' appearance.
+DefaultGUIModel::DefaultGUIModel(std::string name, variable_t *variables,
+                                 size_t size) :
+  QWidget(MainWindow::getInstance()->centralWidget()),
+  Workspace::Instance(name, variables, size),
+  paused(false), periodEventPaused(false)
+{
+  size_t nstate = 0, nparam = 0, nevent = 0, ncomment = 0;
+  for (size_t i = 0; i < size; i++)
+  {
+    if (variables[i].flags & (PARAMETER | STATE | EVENT | COMMENT))
+    {
+      param_t param = { NULL, NULL, 0, 0, NULL };
+      param.label = new QLabel(variables[i].name, this);
+      param.edit = new DefaultGUILineEdit(this);
+      if (variables[i].flags & PARAMETER)
+      {
+        param.type = PARAMETER | (variables[i].flags & (DOUBLE | INTEGER | UINTEGER));
+        param.index = nparam++;
+        param.str_value = new QString;
+      }
+      else if (variables[i].flags & STATE)
+      {
+        param.type = STATE;
+        param.index = nstate++;
+      }
+      else if (variables[i].flags & EVENT)
+      {
+        param.type = EVENT;
+        param.index = nevent++;
+      }
+      else
+      {
+        param.type = COMMENT;
+        param.index = ncomment++;
+      }
+      parameter[variables[i].name] = param;
+    }
+  }
+  setActive(true);
+}
+
+DefaultGUIModel::~DefaultGUIModel()
+{
+  std::map<QString, param_t>::iterator i;
+  for (i = parameter.begin(); i != parameter.end(); ++i)
+    delete i->second.str_value;
+}
+
+void DefaultGUIModel::exit()
+{
+  update(EXIT);
+  Plugin::Manager::getInstance()->unload(this);
+}
+
+void DefaultGUIModel::refresh()
+{
+  std::map<QString, param_t>::iterator i;
+  for (i = parameter.begin(); i != parameter.end(); ++i)
+  {
+    if (i->second.type & (STATE | EVENT))
+      i->second.edit->setText(QString::number(getValue(i->second.type, i->second.index)));
+    else if ((i->second.type & PARAMETER) && !i->second.edit->edited() &&
+             i->second.edit->text() != *i->second.str_value)
+      i->second.edit->setText(*i->second.str_value);
+  }
+}
+
+void DefaultGUIModel::modify()
+{
+  bool active = getActive();
+  setActive(false);
+
+  std::map<QString, param_t>::iterator i;
+  for (i = parameter.begin(); i != parameter.end(); ++i)
+  {
+    if (i->second.type & COMMENT)
+      Workspace::Instance::setComment(i->second.index, i->second.edit->text().latin1());
+  }
+
+  update(MODIFY);
+  setActive(active);
+
+  for (i = parameter.begin(); i != parameter.end(); ++i)
+    i->second.edit->blacken();
+}
+
+void DefaultGUIModel::pause(bool p)
+{
+  paused = p;
+  setActive(!p);
+  update(p ? PAUSE : UNPAUSE);
+}
+
+QString DefaultGUIModel::getParameter(const QString &name)
+{
+  std::map<QString, param_t>::iterator n = parameter.find(name);
+  if ((n != parameter.end()) && (n->second.type & PARAMETER))
+  {
+    *n->second.str_value = n->second.edit->text();
+    setValue(n->second.index, n->second.edit->text().toDouble());
+    return n->second.edit->text();
+  }
+  return "";
+}
+
+void DefaultGUIModel::setParameter(const QString &name, double value)
+{
+  std::map<QString, param_t>::iterator n = parameter.find(name);
+  if ((n != parameter.end()) && (n->second.type & PARAMETER))
+  {
+    n->second.edit->setText(QString::number(value));
+    *n->second.str_value = n->second.edit->text();
+    setValue(n->second.index, n->second.edit->text().toDouble());
+  }
+}
+
+void DefaultGUIModel::setParameter(const QString &name, const QString value)
+{
+  std::map<QString, param_t>::iterator n = parameter.find(name);
+  if ((n != parameter.end()) && (n->second.type & PARAMETER))
+  {
+    n->second.edit->setText(value);
+    *n->second.str_value = n->second.edit->text();
+    setValue(n->second.index, n->second.edit->text().toDouble());
+  }
+}
+
+QString DefaultGUIModel::getComment(const QString &name)
+{
+  std::map<QString, param_t>::iterator n = parameter.find(name);
+  if ((n != parameter.end()) && (n->second.type & COMMENT))
+    return QString(getValueString(COMMENT, n->second.index));
+  return "";
+}
+
+void DefaultGUIModel::setComment(const QString &name, const QString comment)
+{
+  std::map<QString, param_t>::iterator n = parameter.find(name);
+  if ((n != parameter.end()) && (n->second.type & COMMENT))
+  {
+    n->second.edit->setText(comment);
+    Workspace::Instance::setComment(n->second.index, comment.latin1());
+  }
+}
+
+void DefaultGUIModel::setState(const QString &name, double &ref)
+{
+  std::map<QString, param_t>::iterator n = parameter.find(name);
+  if ((n != parameter.end()) && (n->second.type & STATE))
+  {
+    setData(Workspace::STATE, n->second.index, &ref);
+    n->second.edit->setText(QString::number(ref));
+  }
+}
+
+void DefaultGUIModel::setEvent(const QString &name, double &ref)
+{
+  std::map<QString, param_t>::iterator n = parameter.find(name);
+  if ((n != parameter.end()) && (n->second.type & EVENT))
+  {
+    setData(Workspace::EVENT, n->second.index, &ref);
+    n->second.edit->setText(QString::number(ref));
+  }
+}
+
+void DefaultGUIModel::doLoad(const Settings::Object::State &s)
+{
+  std::map<QString, param_t>::iterator i;
+  for (i = parameter.begin(); i != parameter.end(); ++i)
+    i->second.edit->setText(s.loadString(i->first));
+  pause(s.loadInteger("paused"));
+  modify();
+}
+
+void DefaultGUIModel::doSave(Settings::Object::State &s) const
+{
+  s.saveInteger("paused", paused);
+  std::map<QString, param_t>::const_iterator i;
+  for (i = parameter.begin(); i != parameter.end(); ++i)
+    s.saveString(i->first, i->second.edit->text());
+}
+
+void DefaultGUIModel::receiveEvent(const ::Event::Object *event)
+{
+  if (event->getName() == ::Event::RT_PREPERIOD_EVENT)
+  {
+    periodEventPaused = getActive();
+    setActive(false);
+  }
+  else if (event->getName() == ::Event::RT_POSTPERIOD_EVENT)
+  {
+    update(PERIOD);
+    setActive(periodEventPaused);
+  }
+}
@@ -0,0 +1,206 @@
+/*
+ * ExecTimer
+ * Worst-case execute() time of a plugin, shown as STATE variables.
+ */
+
+/*
+ * Build a plugin with `make EXECTIME=1` and it shows three extra read-only
+ * fields: the longest execute() since it was loaded, the 99th percentile, and
+ * how many ticks took longer than the whole realtime period. When the
+ * realtime thread overruns, these point at the plugin responsible.
+ *
+ * Times come from the CPU's cycle counter and are binned into a fixed
+ * histogram inside the plugin, so recording never allocates or locks and is
+ * cheap enough to leave on.
+ *
+ * A plugin opts in with four lines:
+ *
+ *   EXECTIME_VARS      at the end of its vars[] table,
+ *   EXECTIME_DECLARE;  in its class's private members,
+ *   EXECTIME_INIT;     in its constructor, and
+ *   EXECTIME_SCOPE;    as the first line of execute().
+ *
+ * Without EXECTIME they all expand to nothing.
+ */
+
+#ifndef EXECTIME_H
+#define EXECTIME_H
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <rt.h>
+
+class ExecTimer
+{
+public:
+  ExecTimer() : maxUs(0.0), p99Us(0.0), overruns(0.0), ticks(0),
+                maxCycles(0), nsPerCycle(calibrate())
+  {
+    memset(histogram, 0, sizeof(histogram));
+    updateBudget();
+  }
+
+  // RTXI reads these directly as STATE variables.
+  double maxUs;
+  double p99Us;
+  double overruns;
+
+  void start()
+  {
+    began = cycles();
+  }
+
+  void stop()
+  {
+    uint64_t elapsed = cycles() - began;
+    histogram[bucket(elapsed)]++;
+    if (elapsed > maxCycles)
+    {
+      maxCycles = elapsed;
+      maxUs = elapsed * nsPerCycle * 1e-3;
+    }
+    if (elapsed > budget)
+      overruns++;
+    // Finding the percentile walks the whole histogram, so only do it now
+    // and then. It also picks up changes to the realtime period.
+    if ((++ticks & (SUMMARY_TICKS - 1)) == 0)
+    {
+      p99Us = percentile(0.99) * nsPerCycle * 1e-3;
+      updateBudget();
+    }
+  }
+
+  // Times the rest of the enclosing block.
+  class Scope
+  {
+  public:
+    Scope(ExecTimer &aTimer) : timer(aTimer) { timer.start(); }
+    ~Scope() { timer.stop(); }
+  private:
+    ExecTimer &timer;
+  };
+
+private:
+  // Four buckets per power of two, from one cycle to 2^64.
+  enum { BUCKETS = 256, SUMMARY_TICKS = 1024 };
+  uint64_t histogram[BUCKETS];
+  uint64_t ticks;
+  uint64_t began;
+  uint64_t maxCycles;
+  uint64_t budget;
+  double nsPerCycle;
+
+  static uint64_t cycles()
+  {
+#if defined(__i386__) || defined(__x86_64__)
+    uint32_t lo, hi;
+    __asm__ __volatile__("rdtsc" : "=a" (lo), "=d" (hi));
+    return ((uint64_t)hi << 32) | lo;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+  }
+
+  // Time a short sleep with both clocks, once per process.
+  static double calibrate()
+  {
+    static double nsPerCycle = 0.0;
+#if defined(__i386__) || defined(__x86_64__)
+    if (nsPerCycle == 0.0)
+    {
+      struct timespec t0, t1, pause = { 0, 10000000 };
+      clock_gettime(CLOCK_MONOTONIC, &t0);
+      uint64_t c0 = cycles();
+      nanosleep(&pause, NULL);
+      clock_gettime(CLOCK_MONOTONIC, &t1);
+      uint64_t c1 = cycles();
+      double ns = (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+      nsPerCycle = ns / (double)(c1 - c0);
+    }
+#else
+    nsPerCycle = 1.0;
+#endif
+    return nsPerCycle;
+  }
+
+  static size_t bucket(uint64_t c)
+  {
+    if (c < 4)
+      return c;
+    int e = 63 - __builtin_clzll(c);
+    return 4 * (e - 1) + ((c >> (e - 2)) & 3);
+  }
+
+  // Largest value that lands in bucket |b|.
+  static uint64_t bucketTop(size_t b)
+  {
+    if (b < 4)
+      return b;
+    int e = b / 4 + 1;
+    return ((uint64_t)(4 + b % 4) << (e - 2)) + ((uint64_t)1 << (e - 2)) - 1;
+  }
+
+  uint64_t percentile(double p) const
+  {
+    uint64_t want = (uint64_t)(ticks * p), seen = 0;
+    for (size_t b = 0; b < BUCKETS; b++)
+    {
+      seen += histogram[b];
+      if (seen > want)
+        return bucketTop(b);
+    }
+    return maxCycles;
+  }
+
+  void updateBudget()
+  {
+    budget = (uint64_t)(RT::System::getInstance()->getPeriod() / nsPerCycle);
+  }
+};
+
+#ifdef EXECTIME
+
+#define EXECTIME_MAX "Exec max (us)"
+#define EXECTIME_P99 "Exec p99 (us)"
+#define EXECTIME_OVERRUNS "Exec overruns"
+
+#define EXECTIME_VARS \
+  { \
+    EXECTIME_MAX, \
+    "Longest execute() since the plugin was loaded (us)", \
+    DefaultGUIModel::STATE, \
+  }, \
+  { \
+    EXECTIME_P99, \
+    "99% of execute() calls finish within this time (us)", \
+    DefaultGUIModel::STATE, \
+  }, \
+  { \
+    EXECTIME_OVERRUNS, \
+    "Number of execute() calls longer than the realtime period", \
+    DefaultGUIModel::STATE, \
+  },
+
+#define EXECTIME_DECLARE ExecTimer execTimer
+
+#define EXECTIME_INIT \
+  setState(EXECTIME_MAX, execTimer.maxUs); \
+  setState(EXECTIME_P99, execTimer.p99Us); \
+  setState(EXECTIME_OVERRUNS, execTimer.overruns)
+
+#define EXECTIME_SCOPE ExecTimer::Scope execTimerScope(execTimer)
+
+#else
+
+#define EXECTIME_VARS
+#define EXECTIME_DECLARE
+#define EXECTIME_INIT
+#define EXECTIME_SCOPE
+
+#endif
+
+#endif /* end of include guard: EXECTIME_H */
@@ -0,0 +1,112 @@
+/*
+ * RingBuffer
+ * Fixed-size, lock-free queue between one producer and one consumer thread.
+ */
+
+/*
+ * Use this to get data out of (or into) the realtime thread instead of
+ * QApplication::postEvent, which allocates and takes a lock. All storage is
+ * inside the RingBuffer itself, so push() and pop() never allocate or block:
+ * push() fails when the ring is full and pop() fails when it's empty.
+ *
+ * Exactly one thread may push and exactly one thread may pop. Capacity must
+ * be a power of two.
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <stddef.h>
+
+// Each side's index sits on its own cache line, so the producer and consumer
+// aren't forever stealing the same line from each other.
+#define RINGBUFFER_CACHE_LINE 64
+
+template <typename T, size_t Capacity>
+class RingBuffer
+{
+public:
+  RingBuffer() : head(0), tail(0) {}
+
+  // Producer only. Returns false (and drops |item|) if the ring is full.
+  bool push(const T &item)
+  {
+    size_t h = head;
+    if (h - tail == Capacity)
+      return false;
+    items[h & (Capacity - 1)] = item;
+    release();
+    head = h + 1;
+    return true;
+  }
+
+  // Consumer only. Returns false if the ring is empty.
+  bool pop(T &item)
+  {
+    const T *next = front();
+    if (!next)
+      return false;
+    item = *next;
+    popFront();
+    return true;
+  }
+
+  // Consumer only. The oldest item, left in place until popFront(), or NULL
+  // if the ring is empty.
+  const T *front() const
+  {
+    size_t t = tail;
+    if (head == t)
+      return NULL;
+    acquire();
+    return const_cast<const T *>(&items[t & (Capacity - 1)]);
+  }
+
+  // Consumer only. Discard the oldest item; the ring must not be empty.
+  void popFront()
+  {
+    release();
+    tail = tail + 1;
+  }
+
+  // Consumer only. Discard everything.
+  void clear()
+  {
+    release();
+    tail = head;
+  }
+
+  // Either side, but only a snapshot: the other thread may change it.
+  size_t size() const { return head - tail; }
+  bool empty() const { return head == tail; }
+  size_t capacity() const { return Capacity; }
+
+private:
+  typedef char capacity_must_be_a_power_of_two[
+    (Capacity & (Capacity - 1)) == 0 ? 1 : -1];
+
+  // x86 doesn't reorder loads with loads or stores with stores, so only the
+  // compiler needs fencing there.
+  static void acquire()
+  {
+#if defined(__i386__) || defined(__x86_64__)
+    __asm__ __volatile__("" ::: "memory");
+#else
+    __sync_synchronize();
+#endif
+  }
+
+  static void release()
+  {
+    acquire();
+  }
+
+  char pad0[RINGBUFFER_CACHE_LINE];
+  volatile size_t head;
+  char pad1[RINGBUFFER_CACHE_LINE - sizeof(size_t)];
+  volatile size_t tail;
+  char pad2[RINGBUFFER_CACHE_LINE - sizeof(size_t)];
+  T items[Capacity];
+};
+
+#endif /* end of include guard: RINGBUFFER_H */
@@ -0,0 +1,80 @@
+/*
+ * Timebase
+ * Time as a count of realtime ticks, and durations as numbers of ticks.
+ */
+
+/*
+ * Adding the realtime period to a double every tick drifts: after a few
+ * hours of 0.1 ms steps the sum is off by whole ticks, and comparisons like
+ * `age - lastFlip >= period` fire a tick early or late depending on rounding.
+ * Counting ticks as an integer is exact however long the experiment runs.
+ *
+ * Durations from parameters are converted to tick counts once, when they're
+ * set (MODIFY) or when the realtime period changes (PERIOD), so execute()
+ * only increments and compares integers. A duration rounds to the nearest
+ * whole tick, which is as finely as anything can happen anyway.
+ *
+ * A plugin keeps one Timebase, calls tick() at the top of execute() and
+ * update() on PERIOD, and then recomputes its tick counts.
+ */
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+
+#include <rt.h>
+
+// Fixed-point tick counts from fineTicks() have this many fractional bits.
+#define TIMEBASE_FRACTION_BITS 32
+#define TIMEBASE_ONE 4294967296.0
+
+class Timebase
+{
+public:
+  Timebase() : count(0) { update(); }
+
+  // Pick up a new realtime period. Tick counts from ticks() are stale after
+  // this and should be recomputed.
+  void update()
+  {
+    periodNs = RT::System::getInstance()->getPeriod();
+  }
+
+  void tick() { count++; }
+  void restart() { count = 0; }
+
+  // Ticks since construction or the last restart().
+  uint64_t now() const { return count; }
+
+  // The nearest whole number of ticks to |seconds|, but at least one. An
+  // infinite (or NaN) duration is as many ticks as there are: never.
+  uint64_t ticks(double seconds) const
+  {
+    double t = seconds * 1e9 / periodNs + 0.5;
+    if (!(t < 18446744073709551615.0))
+      return (uint64_t)-1;
+    return t < 1.0 ? 1 : (uint64_t)t;
+  }
+
+  // |seconds| in ticks without rounding, as a fixed-point number with
+  // TIMEBASE_FRACTION_BITS after the point. Adding these up keeps an exact
+  // average rate for durations that aren't whole ticks.
+  uint64_t fineTicks(double seconds) const
+  {
+    double t = seconds * 1e9 / periodNs * TIMEBASE_ONE + 0.5;
+    if (!(t < 18446744073709551615.0))
+      return (uint64_t)-1;
+    return t < 0.0 ? 0 : (uint64_t)t;
+  }
+
+  // Seconds in |t| ticks, and in one.
+  double seconds(uint64_t t) const { return t * (periodNs * 1e-9); }
+  double period() const { return periodNs * 1e-9; }
+
+private:
+  uint64_t count;
+  long long periodNs;
+};
+
+#endif /* end of include guard: TIMEBASE_H */
@@ -0,0 +1,207 @@
+#include <iir.h>
+#include <string.h>
+
+extern "C" Plugin::Object *createRTXIPlugin(void) {
+    return new IIR();
+}
+
+#define PARAM_PASSBAND_LOW "Low end of passband (Hz)"
+#define PARAM_PASSBAND_HIGH "High end of passband (Hz)"
+#define PARAM_REJECT "Reject band"
+#define PARAM_SAMPLING_RATE "Sampling rate (Hz)"
+#define PARAM_FILTER_TYPE "Filter type"
+#define PARAM_FILTER_ORDER "Filter order"
+#define PARAM_RIPPLE "Passband ripple (dB)"
+#define PARAM_ATTENUATION "Stopband attenuation (dB)"
+
+#define INITIAL_PASSBAND_LOW 5
+#define INITIAL_PASSBAND_HIGH 25
+#define INITIAL_REJECT 0
+#define INITIAL_SAMPLING_RATE 1000.0
+#define INITIAL_FILTER_TYPE IIR_BUTTERWORTH
+#define INITIAL_FILTER_ORDER 4
+#define INITIAL_RIPPLE 1.0
+#define INITIAL_ATTENUATION 60.0
+
+static DefaultGUIModel::variable_t vars[] = {
+  {
+    "Vin 1",
+    "Input signal 1",
+    DefaultGUIModel::INPUT,
+  },
+  {
+    "Vin 2",
+    "Input signal 2",
+    DefaultGUIModel::INPUT,
+  },
+  {
+    "Vin 3",
+    "Input signal 3",
+    DefaultGUIModel::INPUT,
+  },
+  {
+    "Vin 4",
+    "Input signal 4",
+    DefaultGUIModel::INPUT,
+  },
+  {
+    "Vout 1 (filtered)",
+    "Filtered input signal 1",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Vout 2 (filtered)",
+    "Filtered input signal 2",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Vout 3 (filtered)",
+    "Filtered input signal 3",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Vout 4 (filtered)",
+    "Filtered input signal 4",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    PARAM_PASSBAND_LOW,
+    "Attenuate frequencies below this frequency. Zero for a lowpass filter",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_PASSBAND_HIGH,
+    "Attenuate frequencies above this frequency. Half the sampling rate or "
+    "more for a highpass filter",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_REJECT,
+    "1 to attenuate frequencies inside the band instead of outside it "
+    "(a notch, for a narrow band)",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+  },
+  {
+    PARAM_SAMPLING_RATE,
+    "Sample the input signals this often (Hz). Make this at least double the "
+    "highest frequency you wish to filter",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_FILTER_TYPE,
+    "0 for Butterworth (flat), 1 for Chebyshev I (ripple in the passband), "
+    "2 for Chebyshev II (ripple in the stopband), 3 for elliptic (ripple in "
+    "both, sharpest cutoff)",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+  },
+  {
+    PARAM_FILTER_ORDER,
+    "Number of poles, doubled for band-pass and band-reject filters. Higher "
+    "means sharper cutoff but slower execution",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+  },
+  {
+    PARAM_RIPPLE,
+    "How far the passband may dip (dB), for Chebyshev I and elliptic filters",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_ATTENUATION,
+    "How far down the stopband must be (dB), for Chebyshev II and elliptic "
+    "filters",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  EXECTIME_VARS
+};
+
+static size_t num_vars = sizeof(vars)/sizeof(DefaultGUIModel::variable_t);
+
+IIR::IIR(void) : DefaultGUIModel("IIR", ::vars, ::num_vars),
+  kernel(iir_kernel()), samplingRate(0.0), sampleTicks(1), lastSample(0) {
+  memset(filtered, 0, sizeof(filtered));
+  
+  // Set defaults for each parameter.
+  setParameter(PARAM_PASSBAND_LOW, INITIAL_PASSBAND_LOW);
+  setParameter(PARAM_PASSBAND_HIGH, INITIAL_PASSBAND_HIGH);
+  setParameter(PARAM_REJECT, INITIAL_REJECT);
+  setParameter(PARAM_SAMPLING_RATE, INITIAL_SAMPLING_RATE);
+  setParameter(PARAM_FILTER_TYPE, INITIAL_FILTER_TYPE);
+  setParameter(PARAM_FILTER_ORDER, INITIAL_FILTER_ORDER);
+  setParameter(PARAM_RIPPLE, INITIAL_RIPPLE);
+  setParameter(PARAM_ATTENUATION, INITIAL_ATTENUATION);
+  
+  // Get the realtime period, and the coefficients for the defaults.
+  update(PERIOD);
+  update(MODIFY);
+  EXECTIME_INIT;
+  
+  refresh();
+}
+
+IIR::~IIR(void) {}
+
+void IIR::execute(void) {
+  EXECTIME_SCOPE;
+  clock.tick();
+  
+  // Between samples the output doesn't change, so there's nothing to 
+  // recompute.
+  if (clock.now() - lastSample >= sampleTicks)
+  {
+    for (size_t c = 0; c < IIR_CHANNELS; c++)
+      filtered[c] = input(c);
+    if (!sections.empty())
+      kernel(&sections[0], sections.size(), &state[0][0][0], filtered);
+    lastSample = clock.now();
+  }
+  
+  for (size_t c = 0; c < IIR_CHANNELS; c++)
+    output(c) = filtered[c];
+}
+
+void IIR::update(DefaultGUIModel::update_flags_t flag) {
+  std::pair<double, double> passband;
+  iir_type_t type;
+  size_t order;
+  bool reject;
+  switch(flag) {
+    // Cut output on pause; it'll restart in execute() on unpause.
+    case PAUSE:
+      for (size_t c = 0; c < IIR_CHANNELS; c++)
+        output(c) = 0;
+      break;
+    
+    // Grab the new parameters and make a new filter. It's cheap enough to do 
+    // right here, and the filter's history is meaningless to the new one.
+    case MODIFY:
+      samplingRate = getParameter(PARAM_SAMPLING_RATE).toDouble();
+      sampleTicks = clock.ticks(1.0 / samplingRate);
+      passband = std::make_pair(getParameter(PARAM_PASSBAND_LOW).toDouble(), 
+                                getParameter(PARAM_PASSBAND_HIGH).toDouble());
+      passband.first /= samplingRate / 2.0;
+      passband.second /= samplingRate / 2.0;
+      reject = getParameter(PARAM_REJECT).toUInt();
+      type = (iir_type_t)std::min(getParameter(PARAM_FILTER_TYPE).toUInt(), 
+                                  (unsigned int)IIR_ELLIPTIC);
+      order = getParameter(PARAM_FILTER_ORDER).toUInt();
+      if (order > IIR_MAX_SECTIONS)
+      {
+        order = IIR_MAX_SECTIONS;
+        setParameter(PARAM_FILTER_ORDER, order);
+      }
+      iirdesign(sections, type, order, passband, reject, 
+                getParameter(PARAM_RIPPLE).toDouble(), 
+                getParameter(PARAM_ATTENUATION).toDouble());
+      memset(state, 0, sizeof(state));
+      break;
+    
+    // Grab the realtime period, and how many periods go by between samples.
+    case PERIOD:
+      clock.update();
+      sampleTicks = clock.ticks(1.0 / samplingRate);
+      break;
+    
+    default:
+      break;
+  }
+}
@@ -0,0 +1,48 @@
+/*
+ * IIR
+ * Low/high/band-pass or band-reject IIR filter, as a cascade of biquads.
+ */
+
+
+#include <default_gui_model.h>
+#include "../common/exectime.h"
+#include "../common/timebase.h"
+#include "iirdesign.h"
+#include "iirkernel.h"
+#include <vector>
+
+// Enough for a band-pass or band-reject filter of order 16.
+#define IIR_MAX_SECTIONS 16
+
+
+class IIR : public DefaultGUIModel
+{
+
+public:
+
+    IIR(void);
+    virtual ~IIR(void);
+
+    void execute(void);
+
+protected:
+
+    void update(DefaultGUIModel::update_flags_t);
+
+private:
+
+    std::vector<biquad_t> sections;
+    iir_kernel_t kernel;
+    
+    // Two delays per section, one lane per channel; see iirkernel.h.
+    double state[IIR_MAX_SECTIONS][2][IIR_CHANNELS];
+    double filtered[IIR_CHANNELS];
+    
+    double samplingRate;
+    uint64_t sampleTicks;
+    uint64_t lastSample;
+    Timebase clock;
+
+    EXECTIME_DECLARE;
+
+};
@@ -0,0 +1,365 @@
+#include "iirdesign.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+using namespace std;
+
+typedef complex<double> cplx;
+static const cplx J(0.0, 1.0);
+
+// The classic analog prototypes, as poles, zeros and gain, with the passband 
+// edge at 1 rad/s. These follow scipy's buttap, cheb1ap and cheb2ap, and 
+// Orfanidis' "Lecture Notes on Elliptic Filter Design" for ellipap.
+
+static void buttap(size_t n, vector<cplx> &z, vector<cplx> &p, double &k)
+{
+  for (size_t i = 0; i < n; i++)
+    p.push_back(-exp(J * (M_PI * (2.0 * i + 1.0 - n) / (2.0 * n))));
+  k = 1.0;
+}
+
+static void cheb1ap(size_t n, double rp, vector<cplx> &z, vector<cplx> &p, 
+                    double &k)
+{
+  double eps = sqrt(pow(10.0, 0.1 * rp) - 1.0);
+  double mu = asinh(1.0 / eps) / n;
+  cplx gain = 1.0;
+  for (size_t i = 0; i < n; i++) {
+    double theta = M_PI * (2.0 * i + 1.0 - n) / (2.0 * n);
+    p.push_back(-sinh(cplx(mu, theta)));
+    gain *= -p.back();
+  }
+  k = gain.real();
+  if (n % 2 == 0)
+    k /= sqrt(1.0 + eps * eps);
+}
+
+static void cheb2ap(size_t n, double rs, vector<cplx> &z, vector<cplx> &p, 
+                    double &k)
+{
+  double de = 1.0 / sqrt(pow(10.0, 0.1 * rs) - 1.0);
+  double mu = asinh(1.0 / de) / n;
+  // Where the response is 3 dB down, so it can be moved to 1.
+  double w3 = 1.0 / cosh(acosh(1.0 / de) / n);
+  for (size_t i = 0; i < n; i++) {
+    double m = 2.0 * i + 1.0 - n;
+    if (m != 0.0)
+      z.push_back(-conj(J / sin(m * M_PI / (2.0 * n))) / w3);
+    cplx q = -exp(J * (M_PI * m / (2.0 * n)));
+    q = cplx(sinh(mu) * q.real(), cosh(mu) * q.imag());
+    p.push_back(1.0 / q / w3);
+  }
+  cplx gain = 1.0;
+  for (size_t i = 0; i < p.size(); i++)
+    gain *= -p[i];
+  for (size_t i = 0; i < z.size(); i++)
+    gain /= -z[i];
+  k = gain.real();
+}
+
+// Descending Landen moduli of |k|.
+static vector<double> landen(double k)
+{
+  vector<double> v;
+  for (int i = 0; i < 7 && k > 1e-15; i++) {
+    k = k / (1.0 + sqrt(1.0 - k * k));
+    k *= k;
+    v.push_back(k);
+  }
+  return v;
+}
+
+static double ellipk(double k)
+{
+  vector<double> v = landen(k);
+  double K = M_PI / 2.0;
+  for (size_t i = 0; i < v.size(); i++)
+    K *= 1.0 + v[i];
+  return K;
+}
+
+// Jacobi cd and sn, with u in units of K.
+static cplx cde(cplx u, double k)
+{
+  vector<double> v = landen(k);
+  cplx w = cos(u * M_PI / 2.0);
+  for (size_t i = v.size(); i-- > 0; )
+    w = (1.0 + v[i]) * w / (1.0 + v[i] * w * w);
+  return w;
+}
+
+static cplx sne(cplx u, double k)
+{
+  vector<double> v = landen(k);
+  cplx w = sin(u * M_PI / 2.0);
+  for (size_t i = v.size(); i-- > 0; )
+    w = (1.0 + v[i]) * w / (1.0 + v[i] * w * w);
+  return w;
+}
+
+static double srem(double x, double y)
+{
+  return x - y * floor(x / y + 0.5);
+}
+
+// Inverse of cde, reduced to the fundamental rectangle.
+static cplx acde(cplx w, double k)
+{
+  vector<double> v = landen(k);
+  double prev = k;
+  for (size_t i = 0; i < v.size(); i++) {
+    w = w / (1.0 + sqrt(1.0 - w * w * prev * prev)) * 2.0 / (1.0 + v[i]);
+    prev = v[i];
+  }
+  // acos(w), which C++98 doesn't have for complex numbers.
+  cplx u = -J * log(w + J * sqrt(1.0 - w * w)) * (2.0 / M_PI);
+  double R = ellipk(sqrt(1.0 - k * k)) / ellipk(k);
+  return cplx(srem(u.real(), 4.0), srem(u.imag(), 2.0 * R));
+}
+
+static cplx asne(cplx w, double k)
+{
+  return 1.0 - acde(w, k);
+}
+
+// The elliptic modulus that an order |n| filter with modulus |k1| needs.
+static double ellipdeg(size_t n, double k1)
+{
+  double k1p = sqrt(1.0 - k1 * k1);
+  double kp = pow(k1p, (double)n);
+  for (size_t i = 1; i <= n / 2; i++)
+    kp *= pow(sne((2.0 * i - 1.0) / n, k1p).real(), 4.0);
+  return sqrt(1.0 - kp * kp);
+}
+
+static void ellipap(size_t n, double rp, double rs, 
+                    vector<cplx> &z, vector<cplx> &p, double &k)
+{
+  double ep = sqrt(pow(10.0, 0.1 * rp) - 1.0);
+  double es = sqrt(pow(10.0, 0.1 * rs) - 1.0);
+  double k1 = ep / es;
+  double kk = ellipdeg(n, k1);
+  double v0 = (-J * asne(J / ep, k1) / (double)n).real();
+  for (size_t i = 1; i <= n / 2; i++) {
+    double u = (2.0 * i - 1.0) / n;
+    cplx zeta = cde(u, kk);
+    z.push_back(J / (kk * zeta));
+    z.push_back(conj(z.back()));
+    p.push_back(J * cde(cplx(u, -v0), kk));
+    p.push_back(conj(p.back()));
+  }
+  if (n % 2)
+    p.push_back(cplx((J * sne(cplx(0.0, v0), kk)).real(), 0.0));
+  cplx gain = 1.0;
+  for (size_t i = 0; i < p.size(); i++)
+    gain *= -p[i];
+  for (size_t i = 0; i < z.size(); i++)
+    gain /= -z[i];
+  k = gain.real();
+  if (n % 2 == 0)
+    k /= sqrt(1.0 + ep * ep);
+}
+
+static cplx product(const vector<cplx> &v, cplx offset)
+{
+  cplx result = 1.0;
+  for (size_t i = 0; i < v.size(); i++)
+    result *= offset - v[i];
+  return result;
+}
+
+// Pair poles and zeros into sections. Poles nearest the unit circle are 
+// matched first, each with its nearest zeros, and go last in the cascade.
+static void zpk2sos(vector<cplx> z, vector<cplx> p, double k, 
+                    vector<biquad_t> &sections)
+{
+  // Keep one of each conjugate pair; real ones stand alone.
+  vector<cplx> poles, zeros;
+  for (size_t i = 0; i < p.size(); i++) {
+    if (p[i].imag() >= -1e-12 * abs(p[i]))
+      poles.push_back(p[i]);
+  }
+  for (size_t i = 0; i < z.size(); i++) {
+    if (z[i].imag() >= -1e-12 * abs(z[i]))
+      zeros.push_back(z[i]);
+  }
+
+  vector<biquad_t> reversed;
+  while (!poles.empty()) {
+    size_t best = 0;
+    for (size_t i = 1; i < poles.size(); i++) {
+      if (abs(1.0 - abs(poles[i])) < abs(1.0 - abs(poles[best])))
+        best = i;
+    }
+    cplx p1 = poles[best], p2;
+    poles.erase(poles.begin() + best);
+    bool complexPole = abs(p1.imag()) > 1e-12 * abs(p1);
+    size_t order = 2;
+    if (complexPole)
+      p2 = conj(p1);
+    else {
+      // Another real pole to go with it, or a first-order section.
+      size_t other = poles.size();
+      for (size_t i = 0; i < poles.size(); i++) {
+        if (abs(poles[i].imag()) <= 1e-12 * abs(poles[i]) &&
+            (other == poles.size() || 
+             abs(poles[i] - p1) < abs(poles[other] - p1)))
+          other = i;
+      }
+      if (other < poles.size()) {
+        p2 = poles[other];
+        poles.erase(poles.begin() + other);
+      }
+      else
+        order = 1;
+    }
+
+    // Now the nearest zeros: a conjugate pair, or up to |order| real ones.
+    cplx z1 = 0.0, z2 = 0.0;
+    size_t zeroCount = 0;
+    size_t nearest = zeros.size();
+    for (size_t i = 0; i < zeros.size(); i++) {
+      bool complexZero = abs(zeros[i].imag()) > 1e-12 * abs(zeros[i]);
+      if ((order == 2 || !complexZero) && 
+          (nearest == zeros.size() || 
+           abs(zeros[i] - p1) < abs(zeros[nearest] - p1)))
+        nearest = i;
+    }
+    if (nearest < zeros.size()) {
+      z1 = zeros[nearest];
+      zeros.erase(zeros.begin() + nearest);
+      zeroCount = 1;
+      if (abs(z1.imag()) > 1e-12 * abs(z1)) {
+        z2 = conj(z1);
+        zeroCount = 2;
+      }
+      else if (order == 2) {
+        for (size_t i = 0; i < zeros.size(); i++) {
+          if (abs(zeros[i].imag()) <= 1e-12 * abs(zeros[i])) {
+            z2 = zeros[i];
+            zeros.erase(zeros.begin() + i);
+            zeroCount = 2;
+            break;
+          }
+        }
+      }
+    }
+
+    biquad_t s;
+    s.b0 = 1.0;
+    s.b1 = zeroCount == 0 ? 0.0 : -(zeroCount == 2 ? (z1 + z2).real() : z1.real());
+    s.b2 = zeroCount == 2 ? (z1 * z2).real() : 0.0;
+    s.a1 = order == 2 ? -(p1 + p2).real() : -p1.real();
+    s.a2 = order == 2 ? (p1 * p2).real() : 0.0;
+    reversed.push_back(s);
+  }
+
+  sections.assign(reversed.rbegin(), reversed.rend());
+  if (!sections.empty()) {
+    sections[0].b0 *= k;
+    sections[0].b1 *= k;
+    sections[0].b2 *= k;
+  }
+}
+
+void iirdesign(vector<biquad_t> &sections, iir_type_t type, size_t order, 
+               pair<double, double> &passband, bool reject, 
+               double ripple, double attenuation)
+{
+  sections.clear();
+  double left = passband.first, right = passband.second;
+  bool lowpass = left <= 0.0, highpass = right >= 1.0;
+  if (order == 0 || (lowpass && highpass) || left >= right)
+    return;
+
+  vector<cplx> z, p;
+  double k;
+  switch (type) {
+    case IIR_CHEBYSHEV1:
+      cheb1ap(order, ripple, z, p, k);
+      break;
+    case IIR_CHEBYSHEV2:
+      cheb2ap(order, attenuation, z, p, k);
+      break;
+    case IIR_ELLIPTIC:
+      ellipap(order, ripple, attenuation, z, p, k);
+      break;
+    default:
+      buttap(order, z, p, k);
+      break;
+  }
+
+  // Prewarp the band edges for the bilinear transform (with fs = 2), then 
+  // move the prototype's edge there.
+  double w1 = 4.0 * tan(M_PI * left / 2.0);
+  double w2 = 4.0 * tan(M_PI * right / 2.0);
+  size_t degree = p.size() - z.size();
+  if (lowpass != reject && (lowpass || highpass)) {
+    // Lowpass, or the complement of a highpass.
+    double w = lowpass ? w2 : w1;
+    for (size_t i = 0; i < z.size(); i++)
+      z[i] *= w;
+    for (size_t i = 0; i < p.size(); i++)
+      p[i] *= w;
+    k *= pow(w, (double)degree);
+  }
+  else if (lowpass || highpass) {
+    double w = lowpass ? w2 : w1;
+    k *= (product(z, 0.0) / product(p, 0.0)).real();
+    for (size_t i = 0; i < z.size(); i++)
+      z[i] = w / z[i];
+    for (size_t i = 0; i < p.size(); i++)
+      p[i] = w / p[i];
+    z.insert(z.end(), degree, 0.0);
+  }
+  else {
+    double w0 = sqrt(w1 * w2), bw = w2 - w1;
+    vector<cplx> zb, pb;
+    if (!reject) {
+      for (size_t i = 0; i < z.size(); i++) {
+        cplx s = z[i] * bw / 2.0, d = sqrt(s * s - w0 * w0);
+        zb.push_back(s + d);
+        zb.push_back(s - d);
+      }
+      for (size_t i = 0; i < p.size(); i++) {
+        cplx s = p[i] * bw / 2.0, d = sqrt(s * s - w0 * w0);
+        pb.push_back(s + d);
+        pb.push_back(s - d);
+      }
+      zb.insert(zb.end(), degree, 0.0);
+      k *= pow(bw, (double)degree);
+    }
+    else {
+      k *= (product(z, 0.0) / product(p, 0.0)).real();
+      for (size_t i = 0; i < z.size(); i++) {
+        cplx s = bw / 2.0 / z[i], d = sqrt(s * s - w0 * w0);
+        zb.push_back(s + d);
+        zb.push_back(s - d);
+      }
+      for (size_t i = 0; i < p.size(); i++) {
+        cplx s = bw / 2.0 / p[i], d = sqrt(s * s - w0 * w0);
+        pb.push_back(s + d);
+        pb.push_back(s - d);
+      }
+      for (size_t i = 0; i < degree; i++) {
+        zb.push_back(J * w0);
+        zb.push_back(-J * w0);
+      }
+    }
+    z.swap(zb);
+    p.swap(pb);
+  }
+
+  // Bilinear transform.
+  degree = p.size() - z.size();
+  k *= (product(z, 4.0) / product(p, 4.0)).real();
+  for (size_t i = 0; i < z.size(); i++)
+    z[i] = (4.0 + z[i]) / (4.0 - z[i]);
+  for (size_t i = 0; i < p.size(); i++)
+    p[i] = (4.0 + p[i]) / (4.0 - p[i]);
+  z.insert(z.end(), degree, -1.0);
+
+  zpk2sos(z, p, k, sections);
+}
@@ -0,0 +1,34 @@
+#ifndef IIRDESIGN_H
+#define IIRDESIGN_H
+
+#include <vector>
+
+using namespace std;
+
+enum iir_type_t
+{
+  IIR_BUTTERWORTH,  // maximally flat; -3 dB at the band edges
+  IIR_CHEBYSHEV1,   // |ripple| dB of ripple in the passband, -ripple at edges
+  IIR_CHEBYSHEV2,   // flat passband, stopband at least |attenuation| dB down
+  IIR_ELLIPTIC,     // ripple in both; the sharpest for a given order
+};
+
+// One second-order section, in the form
+//   y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+struct biquad_t
+{
+  double b0, b1, b2, a1, a2;
+};
+
+// Fill up |sections| with a cascade of biquads that pass frequencies inside 
+// |passband|, or reject them if |reject| is set. Like firwin, |passband| 
+// should be normalized between zero and one, where one is the Nyquist 
+// frequency; (0, f) gives a lowpass and (f, 1) a highpass. Band-pass and 
+// band-reject filters have twice |order| poles.
+// Chebyshev II edges are where the response is 3 dB down, not where the 
+// stopband starts, so they line up with the other types.
+void iirdesign(vector<biquad_t> &sections, iir_type_t type, size_t order, 
+               pair<double, double> &passband, bool reject, 
+               double ripple, double attenuation);
+
+#endif /* end of include guard: IIRDESIGN_H */
@@ -0,0 +1,63 @@
+#include "iirkernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define IIRKERNEL_X86
+#endif
+
+// One lane per channel. The compiler splits these into whatever registers 
+// the target has: one AVX register, or two SSE2 ones.
+typedef double v4df __attribute__((vector_size(IIR_CHANNELS * sizeof(double))));
+// The same, for loads and stores that may not be 32-byte aligned.
+typedef double v4df_u __attribute__((vector_size(IIR_CHANNELS * sizeof(double)), 
+                                     aligned(sizeof(double))));
+
+// Every channel takes the same path through the same sections, so there are 
+// no branches on the data. Each section is
+//   y  = b0 x + s1
+//   s1 = b1 x - a1 y + s2
+//   s2 = b2 x - a2 y
+static inline __attribute__((always_inline))
+void iir_cascade(const biquad_t *sections, size_t n, double *state, double *io)
+{
+  v4df x = *(const v4df_u *)io;
+  for (size_t i = 0; i < n; i++) {
+    const biquad_t &s = sections[i];
+    v4df_u *delays = (v4df_u *)(state + i * 2 * IIR_CHANNELS);
+    v4df b0 = { s.b0, s.b0, s.b0, s.b0 }, b1 = { s.b1, s.b1, s.b1, s.b1 }, 
+         b2 = { s.b2, s.b2, s.b2, s.b2 }, a1 = { s.a1, s.a1, s.a1, s.a1 }, 
+         a2 = { s.a2, s.a2, s.a2, s.a2 };
+    v4df s1 = delays[0], s2 = delays[1];
+    v4df y = b0 * x + s1;
+    delays[0] = b1 * x - a1 * y + s2;
+    delays[1] = b2 * x - a2 * y;
+    x = y;
+  }
+  *(v4df_u *)io = x;
+}
+
+static void iir_generic(const biquad_t *sections, size_t n, double *state, 
+                        double *io)
+{
+  iir_cascade(sections, n, state, io);
+}
+
+#ifdef IIRKERNEL_X86
+
+__attribute__((target("avx2,fma")))
+static void iir_avx2(const biquad_t *sections, size_t n, double *state, 
+                     double *io)
+{
+  iir_cascade(sections, n, state, io);
+}
+
+#endif
+
+iir_kernel_t iir_kernel()
+{
+#ifdef IIRKERNEL_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return iir_avx2;
+#endif
+  return iir_generic;
+}
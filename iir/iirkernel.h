@@ -0,0 +1,21 @@
+#ifndef IIRKERNEL_H
+#define IIRKERNEL_H
+
+#include <stddef.h>
+#include "iirdesign.h"
+
+// Channels filtered side by side, one per SIMD lane.
+#define IIR_CHANNELS 4
+
+// Runs one sample of IIR_CHANNELS channels through |n| sections, in 
+// transposed direct form II. |io| holds the inputs and gets the outputs; 
+// |state| holds two delays per section per channel, laid out as 
+// state[section][delay][channel].
+typedef void (*iir_kernel_t)(const biquad_t *sections, size_t n, 
+                             double *state, double *io);
+
+// The fastest kernel this CPU can run (AVX2 or plain vectors). Call it from 
+// update(), not from the realtime thread.
+iir_kernel_t iir_kernel();
+
+#endif /* end of include guard: IIRKERNEL_H */
@@ -0,0 +1,281 @@
+#include <multisine.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+
+extern "C" Plugin::Object *createRTXIPlugin(void) {
+    return new Multisine();
+}
+
+#define COMMENT_TONES "Tones"
+#define PARAM_TONE_COUNT "Number of tones"
+#define PARAM_LOWEST_FREQUENCY "Lowest frequency (Hz)"
+#define PARAM_FREQUENCY_STEP "Frequency step (Hz)"
+#define PARAM_AMPLITUDE "Amplitude (V)"
+#define PARAM_SCHROEDER "Schroeder phases"
+#define PARAM_TONE_OUTPUTS "Per-tone outputs"
+
+#define INITIAL_TONE_COUNT 20
+#define INITIAL_LOWEST_FREQUENCY 1.0
+#define INITIAL_FREQUENCY_STEP 1.0
+#define INITIAL_AMPLITUDE 0.1
+#define INITIAL_SCHROEDER 1
+#define INITIAL_TONE_OUTPUTS 0
+
+// Ticks between putting one tone back on its exact phase, taking turns. 
+// That's one sin() and cos() every so often, instead of one per tone in a 
+// single tick.
+#define RESYNC_SPACING 16
+
+static const double TWO_TO_THE_64 = 18446744073709551616.0;
+
+// A phase in cycles as a 64-bit phase, wrapped to [-0.5, 0.5) first so it 
+// fits.
+static uint64_t to_phase(double cycles)
+{
+  return (uint64_t)(int64_t)llrint((cycles - floor(cycles + 0.5)) * 
+                                   TWO_TO_THE_64);
+}
+
+static DefaultGUIModel::variable_t vars[] = {
+  {
+    "V (sum)",
+    "Sum of all the tones",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Tone 1",
+    "Tone 1 on its own, if per-tone outputs are on",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Tone 2",
+    "Tone 2 on its own, if per-tone outputs are on",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Tone 3",
+    "Tone 3 on its own, if per-tone outputs are on",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Tone 4",
+    "Tone 4 on its own, if per-tone outputs are on",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Tone 5",
+    "Tone 5 on its own, if per-tone outputs are on",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Tone 6",
+    "Tone 6 on its own, if per-tone outputs are on",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Tone 7",
+    "Tone 7 on its own, if per-tone outputs are on",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Tone 8",
+    "Tone 8 on its own, if per-tone outputs are on",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    COMMENT_TONES,
+    "Tones as \"frequency (Hz) amplitude (V) [phase (degrees)]\", separated "
+    "by semicolons. Leave empty for evenly spaced tones set by the "
+    "parameters below",
+    DefaultGUIModel::COMMENT,
+  },
+  {
+    PARAM_TONE_COUNT,
+    "Number of evenly spaced tones, if no tones are listed",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+  },
+  {
+    PARAM_LOWEST_FREQUENCY,
+    "Frequency of the first evenly spaced tone",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_FREQUENCY_STEP,
+    "Frequency between evenly spaced tones",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_AMPLITUDE,
+    "Amplitude of each evenly spaced tone",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_SCHROEDER,
+    "1 to choose phases that keep the sum's peaks low (Schroeder's), "
+    "instead of the listed phases. Works best for harmonics of one frequency",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+  },
+  {
+    PARAM_TONE_OUTPUTS,
+    "1 to also output the first few tones on their own",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+  },
+  EXECTIME_VARS
+};
+
+static size_t num_vars = sizeof(vars)/sizeof(DefaultGUIModel::variable_t);
+
+Multisine::Multisine(void) : DefaultGUIModel("Multisine", ::vars, ::num_vars),
+  period(0.0), toneOutputs(false), toneCount(0), paddedCount(0), tick(0), 
+  nextResync(0), ticksToResync(RESYNC_SPACING), kernel(tone_kernel()) {
+  
+  // Set defaults for each parameter.
+  setParameter(PARAM_TONE_COUNT, INITIAL_TONE_COUNT);
+  setParameter(PARAM_LOWEST_FREQUENCY, INITIAL_LOWEST_FREQUENCY);
+  setParameter(PARAM_FREQUENCY_STEP, INITIAL_FREQUENCY_STEP);
+  setParameter(PARAM_AMPLITUDE, INITIAL_AMPLITUDE);
+  setParameter(PARAM_SCHROEDER, INITIAL_SCHROEDER);
+  setParameter(PARAM_TONE_OUTPUTS, INITIAL_TONE_OUTPUTS);
+  
+  update(PERIOD);
+  update(MODIFY);
+  EXECTIME_INIT;
+  
+  refresh();
+}
+
+Multisine::~Multisine(void) {}
+
+void Multisine::execute(void) {
+  EXECTIME_SCOPE;
+  tick++;
+  output(0) = kernel(c, s, cosStep, sinStep, amplitude, tones, paddedCount);
+  if (toneOutputs) {
+    for (size_t i = 0; i < MULTISINE_TONE_OUTPUTS; i++)
+      output(1 + i) = tones[i];
+  }
+  
+  if (--ticksToResync == 0 && toneCount > 0) {
+    resync(nextResync);
+    if (++nextResync == toneCount)
+      nextResync = 0;
+    ticksToResync = RESYNC_SPACING;
+  }
+}
+
+// Put |tone| exactly where it should be at this tick.
+void Multisine::resync(size_t tone) {
+  uint64_t phase = startPhase[tone] + increment[tone] * tick;
+  double angle = 2.0 * M_PI * (double)(int64_t)phase / TWO_TO_THE_64;
+  c[tone] = cos(angle);
+  s[tone] = sin(angle);
+}
+
+// Fill in the tones from the list, or evenly spaced from the parameters. 
+// Any padding up to a whole number of lanes is silent.
+void Multisine::readTones(void) {
+  memset(frequency, 0, sizeof(frequency));
+  memset(amplitude, 0, sizeof(amplitude));
+  memset(startPhase, 0, sizeof(startPhase));
+  toneCount = 0;
+  
+  std::string list = getComment(COMMENT_TONES).latin1();
+  std::replace(list.begin(), list.end(), ',', ';');
+  std::istringstream entries(list);
+  std::string entry;
+  while (toneCount < MULTISINE_MAX_TONES && std::getline(entries, entry, ';')) {
+    std::istringstream fields(entry);
+    double f, a, degrees = 0.0;
+    if (!(fields >> f >> a))
+      continue;
+    fields >> degrees;
+    frequency[toneCount] = f;
+    amplitude[toneCount] = a;
+    startPhase[toneCount] = to_phase(degrees / 360.0);
+    toneCount++;
+  }
+  
+  if (toneCount == 0) {
+    toneCount = std::min((size_t)getParameter(PARAM_TONE_COUNT).toUInt(), 
+                         (size_t)MULTISINE_MAX_TONES);
+    double lowest = getParameter(PARAM_LOWEST_FREQUENCY).toDouble();
+    double step = getParameter(PARAM_FREQUENCY_STEP).toDouble();
+    double a = getParameter(PARAM_AMPLITUDE).toDouble();
+    for (size_t i = 0; i < toneCount; i++) {
+      frequency[i] = lowest + i * step;
+      amplitude[i] = a;
+    }
+  }
+  paddedCount = (toneCount + TONE_LANES - 1) / TONE_LANES * TONE_LANES;
+}
+
+// Schroeder's low-crest-factor phases, for tones with relative powers p: 
+// tone k is set back 2 pi times the sum of (k - l) p_l over the tones l 
+// before it.
+void Multisine::schroederPhases(void) {
+  double total = 0.0;
+  for (size_t i = 0; i < toneCount; i++)
+    total += amplitude[i] * amplitude[i];
+  if (total == 0.0)
+    return;
+  for (size_t k = 0; k < toneCount; k++) {
+    double cycles = 0.0;
+    for (size_t l = 0; l < k; l++)
+      cycles -= (k - l) * amplitude[l] * amplitude[l] / total;
+    startPhase[k] = to_phase(cycles);
+  }
+}
+
+// Per-tick steps for the current period. The angle comes from the integer 
+// increment, so the oscillators and the exact phases agree.
+void Multisine::setSteps(void) {
+  for (size_t i = 0; i < MULTISINE_MAX_TONES; i++) {
+    increment[i] = to_phase(frequency[i] * period);
+    double angle = 2.0 * M_PI * (double)(int64_t)increment[i] / TWO_TO_THE_64;
+    cosStep[i] = cos(angle);
+    sinStep[i] = sin(angle);
+  }
+}
+
+void Multisine::update(DefaultGUIModel::update_flags_t flag) {
+  switch(flag) {
+    // Cut output on pause; it'll restart in execute() on unpause.
+    case PAUSE:
+      for (size_t i = 0; i < 1 + MULTISINE_TONE_OUTPUTS; i++)
+        output(i) = 0;
+      break;
+    
+    // Start the new tones over from their starting phases.
+    case MODIFY:
+      toneOutputs = getParameter(PARAM_TONE_OUTPUTS).toUInt();
+      readTones();
+      if (getParameter(PARAM_SCHROEDER).toUInt())
+        schroederPhases();
+      tick = 0;
+      setSteps();
+      for (size_t i = 0; i < MULTISINE_MAX_TONES; i++)
+        resync(i);
+      memset(tones, 0, sizeof(tones));
+      if (!toneOutputs) {
+        for (size_t i = 0; i < MULTISINE_TONE_OUTPUTS; i++)
+          output(1 + i) = 0;
+      }
+      break;
+    
+    // Carry on from where each tone is now, at the new rate.
+    case PERIOD:
+      for (size_t i = 0; i < MULTISINE_MAX_TONES; i++)
+        startPhase[i] += increment[i] * tick;
+      tick = 0;
+      period = RT::System::getInstance()->getPeriod() * 1e-9;
+      setSteps();
+      for (size_t i = 0; i < MULTISINE_MAX_TONES; i++)
+        resync(i);
+      break;
+    
+    default:
+      break;
+  }
+}
@@ -0,0 +1,64 @@
+/*
+ * Multisine
+ * A sum of sine waves, each with its own frequency, amplitude and phase.
+ */
+
+
+#include <default_gui_model.h>
+#include "../common/exectime.h"
+#include "tonekernel.h"
+#include <stdint.h>
+
+// Tones are kept in arrays this long, laid out for the kernel.
+#define MULTISINE_MAX_TONES 64
+// The first few tones also get outputs of their own.
+#define MULTISINE_TONE_OUTPUTS 8
+
+
+class Multisine : public DefaultGUIModel
+{
+
+public:
+
+    Multisine(void);
+    virtual ~Multisine(void);
+
+    void execute(void);
+
+protected:
+
+    void update(DefaultGUIModel::update_flags_t);
+
+private:
+
+    void readTones(void);
+    void schroederPhases(void);
+    void setSteps(void);
+    void resync(size_t tone);
+
+    double period;
+    bool toneOutputs;
+    size_t toneCount;
+    size_t paddedCount;
+    
+    // Each tone is an oscillator like Sine's was: a point on the unit circle 
+    // turned a step each tick, put back on its exact phase now and then. 
+    // Exact phases are 64-bit integers, in 2^64ths of a cycle, so they're 
+    // good forever.
+    double frequency[MULTISINE_MAX_TONES];
+    double amplitude[MULTISINE_MAX_TONES];
+    double c[MULTISINE_MAX_TONES];
+    double s[MULTISINE_MAX_TONES];
+    double cosStep[MULTISINE_MAX_TONES];
+    double sinStep[MULTISINE_MAX_TONES];
+    double tones[MULTISINE_MAX_TONES];
+    uint64_t startPhase[MULTISINE_MAX_TONES];
+    uint64_t increment[MULTISINE_MAX_TONES];
+    uint64_t tick;
+    size_t nextResync;
+    int ticksToResync;
+    tone_kernel_t kernel;
+
+    EXECTIME_DECLARE;
+
+};
@@ -0,0 +1,85 @@
+#include "tonekernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TONEKERNEL_X86
+#endif
+
+// Vectors as wide as each target's registers, SSE2 and AVX. Wider ones than 
+// the target has get spilled to the stack, so TONE_LANES tones are split 
+// into however many of these it takes.
+typedef double v2df __attribute__((vector_size(16)));
+typedef double v4df __attribute__((vector_size(32)));
+
+template <typename V>
+static inline __attribute__((always_inline)) void load(V &v, const double *p)
+{
+  __builtin_memcpy(&v, p, sizeof(v));
+}
+
+template <typename V>
+static inline __attribute__((always_inline)) void store(double *p, const V &v)
+{
+  __builtin_memcpy(p, &v, sizeof(v));
+}
+
+// Every tone does the same multiply-adds, so there are no branches on the 
+// data, and the tones don't depend on each other.
+template <typename V>
+static inline __attribute__((always_inline))
+double tone_rotate(double *c, double *s, const double *cosStep, 
+                   const double *sinStep, const double *amplitude, 
+                   double *tones, size_t n)
+{
+  enum { LANES = sizeof(V) / sizeof(double) };
+  V sum = V() * 0.0;
+  for (size_t i = 0; i < n; i += LANES) {
+    V ci, si, cs, ss, a;
+    load(ci, c + i);
+    load(si, s + i);
+    load(cs, cosStep + i);
+    load(ss, sinStep + i);
+    load(a, amplitude + i);
+    V turned = ci * cs - si * ss;
+    si = si * cs + ci * ss;
+    store(c + i, turned);
+    store(s + i, si);
+    V out = a * si;
+    store(tones + i, out);
+    sum += out;
+  }
+  double lanes[LANES];
+  store(lanes, sum);
+  double total = 0.0;
+  for (size_t i = 0; i < LANES; i++)
+    total += lanes[i];
+  return total;
+}
+
+static double tone_sse2(double *c, double *s, const double *cosStep, 
+                        const double *sinStep, const double *amplitude, 
+                        double *tones, size_t n)
+{
+  return tone_rotate<v2df>(c, s, cosStep, sinStep, amplitude, tones, n);
+}
+
+#ifdef TONEKERNEL_X86
+
+__attribute__((target("avx2,fma")))
+static double tone_avx2(double *c, double *s, const double *cosStep, 
+                        const double *sinStep, const double *amplitude, 
+                        double *tones, size_t n)
+{
+  return tone_rotate<v4df>(c, s, cosStep, sinStep, amplitude, tones, n);
+}
+
+#endif
+
+tone_kernel_t tone_kernel()
+{
+#ifdef TONEKERNEL_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return tone_avx2;
+#endif
+  return tone_sse2;
+}
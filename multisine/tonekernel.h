@@ -0,0 +1,22 @@
+#ifndef TONEKERNEL_H
+#define TONEKERNEL_H
+
+#include <stddef.h>
+
+// Tones are processed this many at a time; arrays are padded to a multiple 
+// of it with silent tones.
+#define TONE_LANES 4
+
+// Advances |n| oscillators by one tick and returns the sum of their outputs. 
+// Each is a point (c[i], s[i]) on the unit circle, turned by (cosStep[i], 
+// sinStep[i]); its output amplitude[i] * s[i] goes in tones[i].
+typedef double (*tone_kernel_t)(double *c, double *s, const double *cosStep, 
+                                const double *sinStep, 
+                                const double *amplitude, double *tones, 
+                                size_t n);
+
+// The fastest kernel this CPU can run (AVX2 or SSE2). Call it from update(), 
+// not from the realtime thread.
+tone_kernel_t tone_kernel();
+
+#endif /* end of include guard: TONEKERNEL_H */
@@ -58,6 +58,7 @@ static DefaultGUIModel::variable_t vars[] = {
     "If the output (after scaling and offsetting) would exceed this, cap it",
     DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
   },
+  EXECTIME_VARS
 };
 
 static size_t num_vars = sizeof(vars)/sizeof(DefaultGUIModel::variable_t);
@@ -66,6 +67,7 @@ Mux::Mux(void) : DefaultGUIModel("Mux", ::vars, ::num_vars) {
   Vmax = INITIAL_V_MAX; setParameter(PARAM_V_MAX, Vmax);
   factor = 1.0; setParameter(PARAM_SCALE_FACTOR, factor);
   offset = 0.0; setParameter(PARAM_OFFSET, offset);
+  EXECTIME_INIT;
   
   refresh();
 }
@@ -73,6 +75,7 @@ Mux::Mux(void) : DefaultGUIModel("Mux", ::vars, ::num_vars) {
 Mux::~Mux(void) {}
 
 void Mux::execute(void) {
+  EXECTIME_SCOPE;
   Vout = input(0) + input(1) + input(2) + input(3) + input(4);
   Vout *= factor;
   Vout += offset;
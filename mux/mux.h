@@ -10,6 +10,7 @@
  */
 
 #include <default_gui_model.h>
+#include "../common/exectime.h"
 
 
 // Output the sum of all input voltages, optionally amplified and offset.
@@ -34,4 +35,6 @@ private:
     double offset;
     double Vout;
 
+    EXECTIME_DECLARE;
+
 };
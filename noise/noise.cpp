@@ -18,6 +18,7 @@
 
 #include <noise.h>
 #include <math.h>
+#include <time.h>
 
 extern "C" Plugin::Object *createRTXIPlugin(void) {
     return new Noise();
@@ -26,6 +27,10 @@ extern "C" Plugin::Object *createRTXIPlugin(void) {
 #define PARAM_HALF_AMPLITUDE "Half amplitude (V)"
 #define PARAM_OFFSET "Offset (V)"
 #define PARAM_OUTPUT_RATE "Output rate (Hz)"
+#define PARAM_DISTRIBUTION "Distribution"
+#define PARAM_SEED "Seed"
+#define PARAM_COLOR "Color"
+#define PARAM_TAU "Tau (ms)"
 
 static DefaultGUIModel::variable_t vars[] = {
     {
@@ -40,12 +45,13 @@ static DefaultGUIModel::variable_t vars[] = {
     },
     {
         PARAM_HALF_AMPLITUDE,
-        "Half the amplitude of the noise (i.e. the mean)",
+        "Half the amplitude of uniform noise, the standard deviation of "
+        "Gaussian or colored noise, or the mean of exponential noise",
         DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
     },
     {
         PARAM_OFFSET,
-        "Offset the entire output by this much",
+        "Offset the entire output by this much (the mean, for colored noise)",
         DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
     },
     {
@@ -53,6 +59,30 @@ static DefaultGUIModel::variable_t vars[] = {
         "How often to change output to a new random voltage",
         DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
     },
+    {
+        PARAM_DISTRIBUTION,
+        "0 for uniform, 1 for Gaussian, 2 for exponential",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+    },
+    {
+        PARAM_COLOR,
+        "0 for white noise, 1 for pink (1/f), 2 for brown (1/f^2), 3 for "
+        "Ornstein-Uhlenbeck. Colored noise is always Gaussian.",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+    },
+    {
+        PARAM_TAU,
+        "Correlation time of Ornstein-Uhlenbeck noise, or how long brown noise "
+        "takes to wander one standard deviation (ms)",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+    },
+    {
+        PARAM_SEED,
+        "The same seed gives the same noise every time. Set to 0 for a new "
+        "one.",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+    },
+    EXECTIME_VARS
 };
 
 static size_t num_vars = sizeof(vars)/sizeof(DefaultGUIModel::variable_t);
@@ -62,16 +92,19 @@ Noise::Noise(void)
     /*
      * Initialize Parameters & Variables
      */
-    update(PERIOD);
-    
     halfAmplitude = 0.5; setParameter(PARAM_HALF_AMPLITUDE, halfAmplitude);
     offset = 0.0; setParameter(PARAM_OFFSET, offset);
     period = 1.0; setParameter(PARAM_OUTPUT_RATE, 1000.0 / period);
-    lastChange = 0.0;
-    age = 0.0;
+    distribution = UNIFORM; setParameter(PARAM_DISTRIBUTION, distribution);
+    color = WHITE; setParameter(PARAM_COLOR, color);
+    tau = 10.0; setParameter(PARAM_TAU, tau);
+    wander = 0.0;
+    setParameter(PARAM_SEED, 0);
+    lastChange = 0;
+    update(PERIOD);
     update(MODIFY);
     
-    srand(time(0));
+    EXECTIME_INIT;
 
     refresh();
 }
@@ -79,31 +112,97 @@ Noise::Noise(void)
 Noise::~Noise(void) {}
 
 void Noise::execute(void) {
-    age += dt_ms;
+    EXECTIME_SCOPE;
+    clock.tick();
     if (input(0) != 0.0) {
       output(0) = 0.0;
     }
-    else if (age - lastChange >= period) {
-        output(0) = ((double)rand() * (halfAmplitude * 2)) / 
-                    (double)RAND_MAX - halfAmplitude + offset;
-        lastChange = age;
+    else if (clock.now() - lastChange >= periodTicks) {
+        output(0) = sample();
+        lastChange = clock.now();
     }
 }
 
 void Noise::update(DefaultGUIModel::update_flags_t flag) {
+    unsigned int seed;
     switch (flag) {
         case MODIFY:
             halfAmplitude = getParameter(PARAM_HALF_AMPLITUDE).toDouble();
             offset = getParameter(PARAM_OFFSET).toDouble();
             period = 1000.0 / getParameter(PARAM_OUTPUT_RATE).toDouble();
+            periodTicks = clock.ticks(period * 1e-3);
+            distribution = getParameter(PARAM_DISTRIBUTION).toUInt();
+            if (distribution > EXPONENTIAL) {
+                distribution = UNIFORM;
+                setParameter(PARAM_DISTRIBUTION, distribution);
+            }
+            // Every Modify replays the noise from the top, so show whatever 
+            // seed we pick. It goes in as a string, since a double would only
+            // show six digits of it.
+            seed = getParameter(PARAM_SEED).toUInt();
+            if (seed == 0) {
+                seed = newSeed();
+                setParameter(PARAM_SEED, QString::number(seed));
+            }
+            rng.reseed(seed);
+            
+            color = getParameter(PARAM_COLOR).toUInt();
+            if (color > ORNSTEIN_UHLENBECK) {
+                color = WHITE;
+                setParameter(PARAM_COLOR, color);
+            }
+            tau = getParameter(PARAM_TAU).toDouble();
+            if (tau < clock.period() * 1e3) {
+                tau = clock.period() * 1e3;
+                setParameter(PARAM_TAU, tau);
+            }
+            updateColor();
+            // Pink and OU noise start out already settled.
+            pink.reset(rng);
+            wander = color == ORNSTEIN_UHLENBECK ? 
+                     halfAmplitude * rng.normal() : 0.0;
+            
+            clock.restart();
+            lastChange = 0;
             break;
         case PAUSE:
             output(0) = 0;
             break;
         case PERIOD:
-            dt_ms = RT::System::getInstance()->getPeriod() * 1e-6;
+            clock.update();
+            periodTicks = clock.ticks(period * 1e-3);
+            updateColor();
             break;
         default:
             break;
     }
 }
+
+// Brown and OU noise step once per output, |periodTicks| apart. OU's update 
+// is exact for any step: the mean-reverting decay and the noise that builds 
+// up over the step, not a small-step approximation of them. Brown noise is 
+// the same without the decay, so it wanders without limit.
+void Noise::updateColor(void) {
+    double steps = clock.seconds(periodTicks) / (tau * 1e-3);
+    if (color == ORNSTEIN_UHLENBECK) {
+        decay = exp(-steps);
+        kick = halfAmplitude * sqrt(1.0 - decay * decay);
+    } else {
+        decay = 1.0;
+        kick = halfAmplitude * sqrt(steps);
+    }
+}
+
+// Something different for every instance and every time, that still fits in
+// the seed field.
+unsigned int Noise::newSeed(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    Rng mix((uint64_t)now.tv_sec * 1000000000 + now.tv_nsec + 
+            (uintptr_t)this);
+    unsigned int seed;
+    do {
+        seed = mix.next() >> 33;
+    } while (seed == 0);
+    return seed;
+}
@@ -17,6 +17,10 @@
  */
 
 #include <default_gui_model.h>
+#include "../common/exectime.h"
+#include "../common/timebase.h"
+#include "rng.h"
+#include "pink.h"
 
 class Noise : public DefaultGUIModel
 {
@@ -34,11 +38,59 @@ protected:
 
 private:
 
-    double dt_ms;
-    double age;
-    double lastChange;
+    Timebase clock;
+    uint64_t lastChange;
+    uint64_t periodTicks;
     double halfAmplitude;
     double offset;
     double period;
 
+    enum Distribution { UNIFORM, GAUSSIAN, EXPONENTIAL };
+    unsigned int distribution;
+    Rng rng;
+    unsigned int newSeed(void);
+
+    // One draw from |distribution|, spread over about [-1, 1].
+    double draw(void)
+    {
+        switch (distribution) {
+            case GAUSSIAN:
+                return rng.normal();
+            case EXPONENTIAL:
+                return rng.exponential();
+            default:
+                return 2.0 * rng.uniform() - 1.0;
+        }
+    }
+
+    // Colored noise is always driven by Gaussian draws, with |offset| as its
+    // mean and |halfAmplitude| as its standard deviation. Brown and OU noise
+    // keep their current distance from the mean in |wander|; each step 
+    // keeps |decay| of it and adds a kick of standard deviation |kick|.
+    enum Color { WHITE, PINK, BROWN, ORNSTEIN_UHLENBECK };
+    unsigned int color;
+    double tau;
+    PinkNoise pink;
+    double wander;
+    double decay;
+    double kick;
+    void updateColor(void);
+
+    // The next output, in volts.
+    double sample(void)
+    {
+        switch (color) {
+            case PINK:
+                return halfAmplitude * pink.next(rng) + offset;
+            case BROWN:
+            case ORNSTEIN_UHLENBECK:
+                wander = wander * decay + kick * rng.normal();
+                return wander + offset;
+            default:
+                return halfAmplitude * draw() + offset;
+        }
+    }
+
+    EXECTIME_DECLARE;
+
 };
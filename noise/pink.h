@@ -0,0 +1,67 @@
+/*
+ * PinkNoise
+ * 1/f noise by the Voss-McCartney method.
+ */
+
+/*
+ * The sum of PINK_ROWS random values, where row k is redrawn every 2^k
+ * samples, plus a fresh one each sample. Each octave of frequency gets
+ * about as much power as the next, which is what 1/f means. Only one row
+ * changes per sample (the one picked by the counter's trailing zeros), so
+ * this costs two draws and a couple of adds however many octaves it spans.
+ */
+
+#ifndef PINK_H
+#define PINK_H
+
+#include <stdint.h>
+#include <math.h>
+
+#include "rng.h"
+
+// Sixteen octaves: at a kilohertz, flat down to about 0.015 Hz.
+#define PINK_ROWS 16
+
+class PinkNoise
+{
+public:
+  PinkNoise() : counter(0), sum(0.0)
+  {
+    for (size_t k = 0; k < PINK_ROWS; k++)
+      rows[k] = 0.0;
+  }
+
+  // Start with every row already drawn, so the output's level is right from
+  // the first sample.
+  void reset(Rng &rng)
+  {
+    counter = 0;
+    sum = 0.0;
+    for (size_t k = 0; k < PINK_ROWS; k++) {
+      rows[k] = rng.normal();
+      sum += rows[k];
+    }
+  }
+
+  // Standard deviation one.
+  double next(Rng &rng)
+  {
+    counter++;
+    if (counter != 0) {
+      unsigned int k = __builtin_ctz(counter);
+      if (k < PINK_ROWS) {
+        double row = rng.normal();
+        sum += row - rows[k];
+        rows[k] = row;
+      }
+    }
+    return (sum + rng.normal()) * (1.0 / sqrt(PINK_ROWS + 1.0));
+  }
+
+private:
+  uint32_t counter;
+  double rows[PINK_ROWS];
+  double sum;
+};
+
+#endif /* end of include guard: PINK_H */
@@ -0,0 +1,121 @@
+#include "rng.h"
+
+#include <math.h>
+
+// Layers in each ziggurat, and where the base layer's tail starts.
+#define NORMAL_LAYERS 128
+#define NORMAL_R 3.442619855899
+#define NORMAL_AREA 9.91256303526217e-3
+#define EXPONENTIAL_LAYERS 256
+#define EXPONENTIAL_R 7.69711747013104972
+#define EXPONENTIAL_AREA 3.949659822581572e-3
+
+namespace
+{
+
+// Each ziggurat is a stack of equal-area layers under its curve f, with
+// x[i] the width of layer i and x[0] the base layer, tail and all, as a
+// rectangle. A point inside the next layer's width is always under the
+// curve; only the sliver beyond it needs f itself.
+struct Ziggurat
+{
+  double x[EXPONENTIAL_LAYERS + 1];
+  double f[EXPONENTIAL_LAYERS + 1];
+
+  Ziggurat(size_t layers, double r, double area, double (*curve)(double),
+           double (*inverse)(double))
+  {
+    x[0] = area / curve(r);
+    x[1] = r;
+    for (size_t i = 2; i < layers; i++)
+      x[i] = inverse(area / x[i - 1] + curve(x[i - 1]));
+    x[layers] = 0.0;
+    for (size_t i = 0; i <= layers; i++)
+      f[i] = curve(x[i]);
+  }
+};
+
+double gaussian(double x)
+{
+  return exp(-0.5 * x * x);
+}
+
+double gaussianInverse(double y)
+{
+  return sqrt(-2.0 * log(y));
+}
+
+double decay(double x)
+{
+  return exp(-x);
+}
+
+double decayInverse(double y)
+{
+  return -log(y);
+}
+
+const Ziggurat normalZiggurat(NORMAL_LAYERS, NORMAL_R, NORMAL_AREA,
+                              gaussian, gaussianInverse);
+const Ziggurat exponentialZiggurat(EXPONENTIAL_LAYERS, EXPONENTIAL_R,
+                                   EXPONENTIAL_AREA, decay, decayInverse);
+
+// Spreads a seed's bits over the whole state, so that small seeds like 1, 2
+// and 3 still give unrelated sequences.
+uint64_t splitmix64(uint64_t &x)
+{
+  uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+}
+
+void Rng::reseed(uint64_t seed)
+{
+  for (size_t i = 0; i < 4; i++)
+    s[i] = splitmix64(seed);
+}
+
+// The low bits pick a layer and the high ones a point across it.
+double Rng::normal()
+{
+  const Ziggurat &z = normalZiggurat;
+  for (;;) {
+    uint64_t bits = next();
+    size_t i = bits & (NORMAL_LAYERS - 1);
+    double u = 2.0 * ((bits >> 11) * (1.0 / 9007199254740992.0)) - 1.0;
+    double x = u * z.x[i];
+    if (fabs(x) < z.x[i + 1])
+      return x;
+    if (i == 0) {
+      // Beyond r, from the tail on its own (Marsaglia's method).
+      double t, y;
+      do {
+        t = -log(1.0 - uniform()) / NORMAL_R;
+        y = -log(1.0 - uniform());
+      } while (2.0 * y < t * t);
+      return u < 0.0 ? -(NORMAL_R + t) : NORMAL_R + t;
+    }
+    if (z.f[i] + uniform() * (z.f[i + 1] - z.f[i]) < gaussian(x))
+      return x;
+  }
+}
+
+double Rng::exponential()
+{
+  const Ziggurat &z = exponentialZiggurat;
+  for (;;) {
+    uint64_t bits = next();
+    size_t i = bits & (EXPONENTIAL_LAYERS - 1);
+    double x = ((bits >> 11) * (1.0 / 9007199254740992.0)) * z.x[i];
+    if (x < z.x[i + 1])
+      return x;
+    // The tail of an exponential is another exponential, just shifted.
+    if (i == 0)
+      return EXPONENTIAL_R - log(1.0 - uniform());
+    if (z.f[i] + uniform() * (z.f[i + 1] - z.f[i]) < decay(x))
+      return x;
+  }
+}
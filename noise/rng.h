@@ -0,0 +1,65 @@
+/*
+ * Rng
+ * A small, fast random number generator, and the distributions Noise uses.
+ */
+
+/*
+ * rand() is one generator for the whole process, behind a lock in glibc, so
+ * every Noise instance contends for it and none can be replayed on its own.
+ * Each Rng is its own xoshiro256** generator: 256 bits of state, a handful
+ * of shifts and multiplies per 64-bit number, and the same sequence every
+ * time from the same seed.
+ *
+ * Gaussian and exponential numbers come from the ziggurat method: nearly
+ * every draw is one table lookup, one multiply and one compare, and only the
+ * rare draw near a curve's edge needs exp() or log().
+ */
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+class Rng
+{
+public:
+  Rng(uint64_t seed = 1) { reseed(seed); }
+
+  // Start the sequence for |seed| over.
+  void reseed(uint64_t seed);
+
+  uint64_t next()
+  {
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+  }
+
+  // Uniform in [0, 1).
+  double uniform()
+  {
+    return (next() >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  // Mean zero, standard deviation one.
+  double normal();
+
+  // Mean one.
+  double exponential();
+
+private:
+  uint64_t s[4];
+
+  static uint64_t rotl(uint64_t x, int k)
+  {
+    return (x << k) | (x >> (64 - k));
+  }
+};
+
+#endif /* end of include guard: RNG_H */
@@ -74,6 +74,7 @@ static DefaultGUIModel::variable_t vars[] = {
     "Cut output if it would exceed this voltage",
     DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
   },
+  EXECTIME_VARS
 };
 
 static size_t num_vars = sizeof(vars)/sizeof(DefaultGUIModel::variable_t);
@@ -87,7 +88,6 @@ Ramp::Ramp(void)
    */
   Vout    = 0.0;
   Vmax    = 9.0;  setParameter(PARAM_V_MAX, Vmax);
-  age     = 0.0;
   
   setParameter(PARAM_RATE_MIN, INITIAL_RATE_MIN);
   setParameter(PARAM_RATE_MAX, INITIAL_RATE_MAX);
@@ -97,6 +97,7 @@ Ramp::Ramp(void)
   setIntervalGenerator(INITIAL_INTERVAL_MIN, INITIAL_INTERVAL_MAX);
 
   update(PERIOD);
+  EXECTIME_INIT;
 
   refresh();
 }
@@ -107,41 +108,42 @@ Ramp::~Ramp(void) {
 }
 
 void Ramp::execute(void) {
-  age += dt;
+  EXECTIME_SCOPE;
+  clock.tick();
   Vout = 0;
   
   switch (state) {
     
     case START:
-      chosenRate = (*rateGenerator)();
-      chosenInterval = (*intervalGenerator)();
-      age = 0;
+      // Convert mV/ms to V per period, and ms to periods.
+      chosenRate = (*rateGenerator)() * clock.period();
+      chosenInterval = clock.ticks((*intervalGenerator)() / 1000.0);
+      clock.restart();
       state = RAMP;
     break;
     
     case RAMP:
-      // Convert mV/ms to V/ms.
-      Vout += (chosenRate / 1000.0) * age;
+      Vout += chosenRate * clock.now();
       // Cut off output when the spike detector fires.
       if (input(0) >= 1) {
         state = WAITFORCELL;
         Vout = 0;
       } else if (Vout > Vmax) {
         Vout = 0;
-        cutOff = age;
+        cutOff = clock.now();
         state = WAIT;
       }
     break;
     
     case WAITFORCELL:
       if (input(0) < 1) {
-        cutOff = age;
+        cutOff = clock.now();
         state = WAIT;
       }
     break;
     
     case WAIT:
-      if (age - cutOff > chosenInterval) {
+      if (clock.now() - cutOff > chosenInterval) {
         state = START;
       }
     break;
@@ -163,7 +165,7 @@ void Ramp::update(DefaultGUIModel::update_flags_t flag) {
       output(0) = 0;
       break;
     case PERIOD:
-      dt = RT::System::getInstance()->getPeriod() * 1e-6;
+      clock.update();
       break;
     default:
       break;
@@ -14,6 +14,8 @@
  */
 
 #include <default_gui_model.h>
+#include "../common/exectime.h"
+#include "../common/timebase.h"
 #include <boost/random.hpp>
 
 using namespace boost;
@@ -35,22 +37,21 @@ protected:
 
 private:
 
-    // milliseconds per realtime period
-    double dt;
     // scratch for calculating output
     double Vout;
     // stop this ramp when this threshold is hit on input
     double Vthresh;
-    // ramps increase at a random rate
+    // ramps increase at a random rate, in volts per realtime period
     double chosenRate;
-    // ramps start after a random interval
-    double chosenInterval;
+    // ramps start after a random interval, in realtime periods
+    uint64_t chosenInterval;
     // trigger a threshold at this output regardless of input
     double Vmax;
-    // track how long we've been running
-    double age;
+    // track how long we've been running, in realtime periods since the 
+    // current ramp started
+    Timebase clock;
     // when we cut the output (threshold or max was hit)
-    double cutOff;
+    uint64_t cutOff;
     
     // State machine for plugin.
     enum State {
@@ -73,4 +74,6 @@ private:
     void setIntervalGenerator(double min, double max);
     void setGenerator(UniformGenerator **generator, double min, double max);
 
+    EXECTIME_DECLARE;
+
 };
@@ -0,0 +1,179 @@
+#include "coefcache.h"
+#include "firwin.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+// Bump the version whenever the layout or the designs themselves change, so 
+// old files are ignored instead of trusted.
+#define CACHE_MAGIC "RFIRCOEF"
+#define CACHE_VERSION 1
+
+// What comes before the coefficients in each file. The whole key is stored, 
+// so a hash collision is a miss rather than the wrong filter.
+struct CacheHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+  CoefficientKey key;
+  uint64_t count;
+};
+
+// Key fields are compared bit for bit, so padding mustn't get in the way.
+static void fill_key(CoefficientKey &out, const CoefficientKey &key)
+{
+  memset(&out, 0, sizeof(out));
+  out.beta = key.beta;
+  out.left = key.left;
+  out.right = key.right;
+  out.samplingRate = key.samplingRate;
+  out.taps = key.taps;
+}
+
+static void fill_header(CacheHeader &header, const CoefficientKey &key, 
+                        uint64_t count)
+{
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+  header.version = CACHE_VERSION;
+  header.headerSize = sizeof(header);
+  fill_key(header.key, key);
+  header.count = count;
+}
+
+// FNV-1a, which is plenty for telling a few thousand designs apart.
+static uint64_t hash(const void *data, size_t size)
+{
+  const unsigned char *bytes = (const unsigned char *)data;
+  uint64_t h = 14695981039346656037ULL;
+  for (size_t i = 0; i < size; i++) {
+    h ^= bytes[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+// Where the cache lives, created if need be; empty if there's nowhere.
+static string cache_directory()
+{
+  string dir;
+  const char *xdg = getenv("XDG_CACHE_HOME");
+  const char *home = getenv("HOME");
+  if (xdg && *xdg)
+    dir = xdg;
+  else if (home && *home)
+    dir = string(home) + "/.cache";
+  else
+    return "";
+  
+  const char *parts[] = { "/rtxi", "/realfir" };
+  mkdir(dir.c_str(), 0755);
+  for (size_t i = 0; i < 2; i++) {
+    dir += parts[i];
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+      return "";
+  }
+  return dir;
+}
+
+static string cache_path(const string &dir, const CoefficientKey &key)
+{
+  CoefficientKey k;
+  fill_key(k, key);
+  char name[32];
+  snprintf(name, sizeof(name), "/%016llx.coef", 
+           (unsigned long long)hash(&k, sizeof(k)));
+  return dir + name;
+}
+
+bool coefficient_cache_load(const CoefficientKey &key, 
+                            vector<double> &coefficients)
+{
+  string dir = cache_directory();
+  if (dir.empty())
+    return false;
+  int fd = open(cache_path(dir, key).c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  
+  struct stat st;
+  void *map = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(CacheHeader))
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return false;
+  
+  CacheHeader expected;
+  fill_header(expected, key, key.taps);
+  const CacheHeader *header = (const CacheHeader *)map;
+  bool hit = memcmp(header, &expected, sizeof(expected)) == 0 && 
+             (size_t)st.st_size == sizeof(CacheHeader) + 
+                                   header->count * sizeof(double);
+  if (hit) {
+    const double *h = (const double *)(header + 1);
+    coefficients.assign(h, h + header->count);
+  }
+  munmap(map, st.st_size);
+  return hit;
+}
+
+void coefficient_cache_store(const CoefficientKey &key, 
+                             const vector<double> &coefficients)
+{
+  string dir = cache_directory();
+  if (dir.empty() || coefficients.size() != key.taps)
+    return;
+  string path = cache_path(dir, key);
+  vector<char> temp(path.begin(), path.end());
+  const char suffix[] = ".XXXXXX";
+  temp.insert(temp.end(), suffix, suffix + sizeof(suffix));
+  
+  int fd = mkstemp(&temp[0]);
+  if (fd < 0)
+    return;
+  FILE *f = fdopen(fd, "wb");
+  if (!f) {
+    close(fd);
+    unlink(&temp[0]);
+    return;
+  }
+  CacheHeader header;
+  fill_header(header, key, coefficients.size());
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1 && 
+            fwrite(&coefficients[0], sizeof(double), coefficients.size(), f) 
+              == coefficients.size();
+  ok = fclose(f) == 0 && ok;
+  if (!ok || rename(&temp[0], path.c_str()) != 0)
+    unlink(&temp[0]);
+}
+
+void design_coefficients(vector<double> &coefficients, 
+                         const pair<double, double> &passband, size_t taps, 
+                         double samplingRate, double beta)
+{
+  CoefficientKey key;
+  key.beta = beta < 0.0 ? -1.0 : beta;
+  key.left = passband.first;
+  key.right = passband.second;
+  key.samplingRate = samplingRate;
+  key.taps = taps + ((taps % 2 == 0) ? 1 : 0);
+  if (coefficient_cache_load(key, coefficients))
+    return;
+  pair<double, double> band = passband;
+  coefficients.resize(key.taps);
+  if (beta < 0.0)
+    firwin(coefficients, band);
+  else
+    firwin(coefficients, band, beta);
+  coefficient_cache_store(key, coefficients);
+}
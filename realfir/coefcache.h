@@ -0,0 +1,52 @@
+/*
+ * Coefficient cache
+ * Designed filters, saved on disk so the same design is only done once.
+ */
+
+/*
+ * Each coefficient set lives in its own small file, named by a hash of what 
+ * went into the design: the window, the number of taps, the passband and the 
+ * sampling rate. Loading a workspace full of filters then only maps a file 
+ * per filter and copies it out, however long or expensive the design.
+ *
+ * The files sit in $XDG_CACHE_HOME/rtxi/realfir (or ~/.cache/rtxi/realfir), 
+ * and are written whole and renamed into place, so several plugins (or 
+ * RTXIs) can share them. Any of them can be deleted at any time.
+ */
+
+#ifndef COEFCACHE_H
+#define COEFCACHE_H
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Everything a design depends on. |beta| is the Kaiser window's shape, or 
+// negative for Hamming, as for FilterDesigner::design.
+struct CoefficientKey
+{
+  double beta;
+  double left, right;
+  double samplingRate;
+  uint64_t taps;
+};
+
+// Fill |coefficients| from the cache, if this design is in it.
+bool coefficient_cache_load(const CoefficientKey &key, 
+                            vector<double> &coefficients);
+
+// Save |coefficients| for next time. Failing to is harmless, so it's silent.
+void coefficient_cache_store(const CoefficientKey &key, 
+                             const vector<double> &coefficients);
+
+// Design a filter for |passband| (normalized as for firwin) at 
+// |samplingRate|, with |taps| taps rounded up to odd and a Kaiser window of 
+// shape |beta| (negative for Hamming), or take it from the cache if it's 
+// been done before.
+void design_coefficients(vector<double> &coefficients, 
+                         const pair<double, double> &passband, size_t taps, 
+                         double samplingRate, double beta);
+
+#endif /* end of include guard: COEFCACHE_H */
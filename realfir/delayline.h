@@ -0,0 +1,57 @@
+/*
+ * DelayLine
+ * The last N samples of a signal, always contiguous in memory.
+ */
+
+#ifndef DELAYLINE_H
+#define DELAYLINE_H
+
+#include <vector>
+
+// Every sample is written twice, N apart, in a buffer of 2N. However far the 
+// write position has wrapped around, the N samples starting there are the 
+// whole history, oldest first, with no wraparound to check for. That lets a 
+// filter hand them straight to a vectorized kernel.
+class DelayLine
+{
+public:
+  DelayLine() : pos(0), length(0) {}
+
+  // Forget everything and hold |n| zeroes.
+  void resize(size_t n)
+  {
+    length = n;
+    line.assign(2 * n, 0.0);
+    pos = 0;
+  }
+
+  // Start over with the newest of |other|'s samples, as many as fit.
+  void copyHistory(const DelayLine &other)
+  {
+    size_t n = length < other.length ? length : other.length;
+    const double *newest = other.samples() + other.length - n;
+    line.assign(2 * length, 0.0);
+    pos = 0;
+    for (size_t i = 0; i < n; i++)
+      push(newest[i]);
+  }
+
+  void push(double sample)
+  {
+    line[pos] = sample;
+    line[pos + length] = sample;
+    if (++pos == length)
+      pos = 0;
+  }
+
+  // The last size() samples, oldest first.
+  const double *samples() const { return &line[pos]; }
+  size_t size() const { return length; }
+
+private:
+  std::vector<double> line;
+  size_t pos;
+  size_t length;
+};
+
+#endif /* end of include guard: DELAYLINE_H */
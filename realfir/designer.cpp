@@ -0,0 +1,95 @@
+#include "designer.h"
+
+#include "coefcache.h"
+#include "partitioned.h"
+
+// Filters long enough that convolving the first two blocks directly is at 
+// most a quarter of the work go to a PartitionedFIR. Blocks are at least 
+// FFT_MIN_BLOCK samples, and long enough to give its helper thread 
+// FFT_DEADLINE_S to transform each one.
+#define FFT_MIN_BLOCK 64
+#define FFT_DEADLINE_S 0.02
+#define FFT_MIN_SPEEDUP 4
+
+double FilterBank::filter(double sample)
+{
+  if (partitioned)
+    return partitioned->filter(sample);
+  line.push(sample);
+  return kernel(line.samples(), &coefficients[0], line.size());
+}
+
+FilterDesigner::FilterDesigner(double &lateBlocks) : 
+  pending(NULL), published(NULL), current(NULL), previous(NULL), 
+  taps(0), samplingRate(0.0), beta(-1.0), late(lateBlocks)
+{
+}
+
+FilterDesigner::~FilterDesigner()
+{
+  wait();
+  for (size_t i = 0; i < 3; i++)
+    delete banks[i].partitioned;
+}
+
+void FilterDesigner::design(const pair<double, double> &aPassband, 
+                            size_t aTaps, double aSamplingRate, double aBeta)
+{
+  wait();
+  passband = aPassband;
+  taps = aTaps;
+  samplingRate = aSamplingRate;
+  beta = aBeta;
+  start();
+}
+
+FilterBank *FilterDesigner::takeFilter()
+{
+  FilterBank *bank = pending;
+  if (bank == NULL || !__sync_bool_compare_and_swap(&pending, bank, 
+                                                    (FilterBank *)NULL))
+    return NULL;
+  return bank;
+}
+
+void FilterDesigner::run()
+{
+  // Take back the last design if it's still waiting. Otherwise the realtime 
+  // thread has it, and its bank before that may still be fading out.
+  FilterBank *bank = NULL;
+  if (published) {
+    if (__sync_bool_compare_and_swap(&pending, published, (FilterBank *)NULL))
+      bank = published;
+    else {
+      previous = current;
+      current = published;
+    }
+    published = NULL;
+  }
+  for (size_t i = 0; bank == NULL; i++) {
+    if (&banks[i] != current && &banks[i] != previous)
+      bank = &banks[i];
+  }
+
+  // Anything designed before comes off disk.
+  design_coefficients(bank->coefficients, passband, taps, samplingRate, beta);
+  bank->kernel = fir_kernel(bank->coefficients);
+
+  // Long filters are handed off; they start with an empty history.
+  delete bank->partitioned;
+  bank->partitioned = NULL;
+  size_t block = FFT_MIN_BLOCK;
+  while (block < samplingRate * FFT_DEADLINE_S)
+    block *= 2;
+  if (bank->coefficients.size() >= FFT_MIN_SPEEDUP * 2 * block) {
+    bank->line.resize(0);
+    bank->partitioned = new PartitionedFIR(bank->coefficients, block, late);
+    bank->partitioned->start();
+  }
+  else
+    bank->line.resize(bank->coefficients.size());
+
+  __sync_synchronize();
+  published = bank;
+  pending = bank;
+}
@@ -0,0 +1,68 @@
+#ifndef DESIGNER_H
+#define DESIGNER_H
+
+#include <vector>
+
+#include <qthread.h>
+
+#include "delayline.h"
+#include "firkernel.h"
+
+class PartitionedFIR;
+
+using namespace std;
+
+// One designed filter, ready to run: either direct (coefficients, kernel and 
+// a delay line) or handed to a PartitionedFIR.
+struct FilterBank
+{
+  vector<double> coefficients;
+  fir_kernel_t kernel;
+  DelayLine line;
+  PartitionedFIR *partitioned;
+
+  FilterBank() : kernel(NULL), partitioned(NULL) {}
+
+  // Realtime thread: take one sample, return one output.
+  double filter(double sample);
+};
+
+// Designs filters on its own thread, so the realtime thread never waits for 
+// firwin, and hands each one over through an atomic pointer.
+//
+// There are three banks. At any time the realtime thread may be running one 
+// and crossfading out of another; the third is always free to design into.
+class FilterDesigner : public QThread
+{
+public:
+  // Long filters' late blocks are counted in |late| (see partitioned.h).
+  FilterDesigner(double &late);
+  virtual ~FilterDesigner();
+
+  // GUI thread: start designing a filter. |passband| is normalized to the 
+  // Nyquist frequency, as for firwin. |beta| shapes a Kaiser window, or is 
+  // negative for Hamming. Waits for any design still running.
+  void design(const pair<double, double> &passband, size_t taps, 
+              double samplingRate, double beta);
+
+  // Realtime thread: the newest filter, once per design, or NULL.
+  FilterBank *takeFilter();
+
+  virtual void run();
+
+private:
+  FilterBank banks[3];
+  FilterBank * volatile pending;
+
+  // What this thread knows about the realtime thread's banks: the last one 
+  // published, and the two it took before that (either may still be in use).
+  FilterBank *published, *current, *previous;
+
+  pair<double, double> passband;
+  size_t taps;
+  double samplingRate;
+  double beta;
+  double &late;
+};
+
+#endif /* end of include guard: DESIGNER_H */
@@ -0,0 +1,51 @@
+#include "fft.h"
+
+#include <cmath>
+
+FFT::FFT(size_t size) : n(size), reversed(size), 
+  forwardTwiddles(size / 2), inverseTwiddles(size / 2)
+{
+  size_t bits = 0;
+  while (((size_t)1 << bits) < n)
+    bits++;
+  for (size_t i = 0; i < n; i++) {
+    size_t r = 0;
+    for (size_t b = 0; b < bits; b++)
+      r |= ((i >> b) & 1) << (bits - 1 - b);
+    reversed[i] = r;
+  }
+  for (size_t i = 0; i < n / 2; i++) {
+    double angle = 2.0 * M_PI * i / n;
+    forwardTwiddles[i] = complex<double>(cos(angle), -sin(angle));
+    inverseTwiddles[i] = conj(forwardTwiddles[i]);
+  }
+}
+
+void FFT::forward(complex<double> *data) const
+{
+  transform(data, &forwardTwiddles[0]);
+}
+
+void FFT::inverse(complex<double> *data) const
+{
+  transform(data, &inverseTwiddles[0]);
+}
+
+void FFT::transform(complex<double> *data, 
+                    const complex<double> *twiddles) const
+{
+  for (size_t i = 0; i < n; i++) {
+    if (i < reversed[i])
+      swap(data[i], data[reversed[i]]);
+  }
+  for (size_t half = 1; half < n; half *= 2) {
+    size_t stride = n / (2 * half);
+    for (size_t start = 0; start < n; start += 2 * half) {
+      for (size_t k = 0; k < half; k++) {
+        complex<double> t = twiddles[k * stride] * data[start + half + k];
+        data[start + half + k] = data[start + k] - t;
+        data[start + k] += t;
+      }
+    }
+  }
+}
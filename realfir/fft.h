@@ -0,0 +1,31 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex>
+#include <vector>
+
+using namespace std;
+
+// In-place radix-2 FFT of one fixed size, with the twiddle factors and bit 
+// reversal worked out up front so transforms don't allocate.
+class FFT
+{
+public:
+  // |size| must be a power of two.
+  FFT(size_t size);
+
+  void forward(complex<double> *data) const;
+  // Unscaled: forward() then inverse() multiplies by size().
+  void inverse(complex<double> *data) const;
+
+  size_t size() const { return n; }
+
+private:
+  void transform(complex<double> *data, const complex<double> *twiddles) const;
+
+  size_t n;
+  vector<size_t> reversed;
+  vector<complex<double> > forwardTwiddles, inverseTwiddles;
+};
+
+#endif /* end of include guard: FFT_H */
@@ -0,0 +1,282 @@
+#include "firkernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Below this many taps, reversing the second half of the samples costs more 
+// than the multiplies it saves.
+#define SYMMETRIC_MIN_TAPS 128
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FIRKERNEL_X86
+#include <immintrin.h>
+#endif
+
+// Several independent sums, so each multiply-add doesn't wait on the last.
+static double fir_scalar(const double *x, const double *h, size_t n)
+{
+  double a0 = 0.0, a1 = 0.0, a2 = 0.0, a3 = 0.0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    a0 += x[i] * h[i];
+    a1 += x[i + 1] * h[i + 1];
+    a2 += x[i + 2] * h[i + 2];
+    a3 += x[i + 3] * h[i + 3];
+  }
+  for (; i < n; i++)
+    a0 += x[i] * h[i];
+  return (a0 + a1) + (a2 + a3);
+}
+
+static double fir_symmetric_scalar(const double *x, const double *h, size_t n)
+{
+  size_t half = n / 2;
+  const double *r = x + n - 1;
+  double a0 = 0.0, a1 = 0.0;
+  size_t i = 0;
+  for (; i + 2 <= half; i += 2) {
+    a0 += (x[i] + r[-(ptrdiff_t)i]) * h[i];
+    a1 += (x[i + 1] + r[-(ptrdiff_t)i - 1]) * h[i + 1];
+  }
+  for (; i < half; i++)
+    a0 += (x[i] + r[-(ptrdiff_t)i]) * h[i];
+  if (n % 2)
+    a0 += x[half] * h[half];
+  return a0 + a1;
+}
+
+#ifdef FIRKERNEL_X86
+
+__attribute__((target("sse2")))
+static double fir_sse2(const double *x, const double *h, size_t n)
+{
+  __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd(), 
+          a2 = _mm_setzero_pd(), a3 = _mm_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    a0 = _mm_add_pd(a0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(h + i)));
+    a1 = _mm_add_pd(a1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), 
+                                   _mm_loadu_pd(h + i + 2)));
+    a2 = _mm_add_pd(a2, _mm_mul_pd(_mm_loadu_pd(x + i + 4), 
+                                   _mm_loadu_pd(h + i + 4)));
+    a3 = _mm_add_pd(a3, _mm_mul_pd(_mm_loadu_pd(x + i + 6), 
+                                   _mm_loadu_pd(h + i + 6)));
+  }
+  for (; i + 2 <= n; i += 2)
+    a0 = _mm_add_pd(a0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(h + i)));
+  a0 = _mm_add_pd(_mm_add_pd(a0, a1), _mm_add_pd(a2, a3));
+  double sum[2];
+  _mm_storeu_pd(sum, a0);
+  double accum = sum[0] + sum[1];
+  for (; i < n; i++)
+    accum += x[i] * h[i];
+  return accum;
+}
+
+__attribute__((target("sse2")))
+static double fir_symmetric_sse2(const double *x, const double *h, size_t n)
+{
+  size_t half = n / 2;
+  __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= half; i += 4) {
+    __m128d r0 = _mm_loadu_pd(x + n - 2 - i);
+    __m128d r1 = _mm_loadu_pd(x + n - 4 - i);
+    r0 = _mm_shuffle_pd(r0, r0, 1);
+    r1 = _mm_shuffle_pd(r1, r1, 1);
+    a0 = _mm_add_pd(a0, _mm_mul_pd(_mm_add_pd(_mm_loadu_pd(x + i), r0), 
+                                   _mm_loadu_pd(h + i)));
+    a1 = _mm_add_pd(a1, _mm_mul_pd(_mm_add_pd(_mm_loadu_pd(x + i + 2), r1), 
+                                   _mm_loadu_pd(h + i + 2)));
+  }
+  for (; i + 2 <= half; i += 2) {
+    __m128d r0 = _mm_loadu_pd(x + n - 2 - i);
+    r0 = _mm_shuffle_pd(r0, r0, 1);
+    a0 = _mm_add_pd(a0, _mm_mul_pd(_mm_add_pd(_mm_loadu_pd(x + i), r0), 
+                                   _mm_loadu_pd(h + i)));
+  }
+  a0 = _mm_add_pd(a0, a1);
+  double sum[2];
+  _mm_storeu_pd(sum, a0);
+  double accum = sum[0] + sum[1];
+  for (; i < half; i++)
+    accum += (x[i] + x[n - 1 - i]) * h[i];
+  if (n % 2)
+    accum += x[half] * h[half];
+  return accum;
+}
+
+__attribute__((target("avx2,fma")))
+static double fir_avx2(const double *x, const double *h, size_t n)
+{
+  __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd(), 
+          a2 = _mm256_setzero_pd(), a3 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    a0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(h + i), a0);
+    a1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), 
+                         _mm256_loadu_pd(h + i + 4), a1);
+    a2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8), 
+                         _mm256_loadu_pd(h + i + 8), a2);
+    a3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), 
+                         _mm256_loadu_pd(h + i + 12), a3);
+  }
+  for (; i + 4 <= n; i += 4)
+    a0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(h + i), a0);
+  a0 = _mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3));
+  __m128d half = _mm_add_pd(_mm256_castpd256_pd128(a0), 
+                            _mm256_extractf128_pd(a0, 1));
+  double sum[2];
+  _mm_storeu_pd(sum, half);
+  double accum = sum[0] + sum[1];
+  for (; i < n; i++)
+    accum += x[i] * h[i];
+  return accum;
+}
+
+__attribute__((target("avx2,fma")))
+static double fir_symmetric_avx2(const double *x, const double *h, size_t n)
+{
+  size_t half = n / 2;
+  __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd(), 
+          a2 = _mm256_setzero_pd(), a3 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 16 <= half; i += 16) {
+    __m256d r0 = _mm256_permute4x64_pd(_mm256_loadu_pd(x + n - 4 - i), 0x1b);
+    __m256d r1 = _mm256_permute4x64_pd(_mm256_loadu_pd(x + n - 8 - i), 0x1b);
+    __m256d r2 = _mm256_permute4x64_pd(_mm256_loadu_pd(x + n - 12 - i), 0x1b);
+    __m256d r3 = _mm256_permute4x64_pd(_mm256_loadu_pd(x + n - 16 - i), 0x1b);
+    a0 = _mm256_fmadd_pd(_mm256_add_pd(_mm256_loadu_pd(x + i), r0), 
+                         _mm256_loadu_pd(h + i), a0);
+    a1 = _mm256_fmadd_pd(_mm256_add_pd(_mm256_loadu_pd(x + i + 4), r1), 
+                         _mm256_loadu_pd(h + i + 4), a1);
+    a2 = _mm256_fmadd_pd(_mm256_add_pd(_mm256_loadu_pd(x + i + 8), r2), 
+                         _mm256_loadu_pd(h + i + 8), a2);
+    a3 = _mm256_fmadd_pd(_mm256_add_pd(_mm256_loadu_pd(x + i + 12), r3), 
+                         _mm256_loadu_pd(h + i + 12), a3);
+  }
+  for (; i + 4 <= half; i += 4) {
+    __m256d r0 = _mm256_permute4x64_pd(_mm256_loadu_pd(x + n - 4 - i), 0x1b);
+    a0 = _mm256_fmadd_pd(_mm256_add_pd(_mm256_loadu_pd(x + i), r0), 
+                         _mm256_loadu_pd(h + i), a0);
+  }
+  a0 = _mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3));
+  __m128d sum2 = _mm_add_pd(_mm256_castpd256_pd128(a0), 
+                            _mm256_extractf128_pd(a0, 1));
+  double sum[2];
+  _mm_storeu_pd(sum, sum2);
+  double accum = sum[0] + sum[1];
+  for (; i < half; i++)
+    accum += (x[i] + x[n - 1 - i]) * h[i];
+  if (n % 2)
+    accum += x[half] * h[half];
+  return accum;
+}
+
+// The same as fir_avx2 for exactly N taps, N being one of the few lengths 
+// nearly every filter uses. The compiler unrolls it completely, and the last 
+// partial vector is a masked load instead of a scalar loop, so there are no 
+// loop counters or bounds checks left at all.
+template <size_t N>
+__attribute__((target("avx2,fma")))
+static double fir_avx2_fixed(const double *x, const double *h, size_t)
+{
+  enum { VECTORS = N / 4, TAIL = N % 4 };
+  __m256d a[4] = { _mm256_setzero_pd(), _mm256_setzero_pd(), 
+                   _mm256_setzero_pd(), _mm256_setzero_pd() };
+#pragma GCC unroll 64
+  for (size_t v = 0; v < VECTORS; v++)
+    a[v % 4] = _mm256_fmadd_pd(_mm256_loadu_pd(x + 4 * v), 
+                               _mm256_loadu_pd(h + 4 * v), a[v % 4]);
+  if (TAIL != 0) {
+    const __m256i mask = _mm256_set_epi64x(0, TAIL > 2 ? -1 : 0, 
+                                           TAIL > 1 ? -1 : 0, -1);
+    a[VECTORS % 4] = _mm256_fmadd_pd(
+      _mm256_maskload_pd(x + 4 * VECTORS, mask), 
+      _mm256_maskload_pd(h + 4 * VECTORS, mask), a[VECTORS % 4]);
+  }
+  __m256d sum4 = _mm256_add_pd(_mm256_add_pd(a[0], a[1]), 
+                               _mm256_add_pd(a[2], a[3]));
+  __m128d sum2 = _mm_add_pd(_mm256_castpd256_pd128(sum4), 
+                            _mm256_extractf128_pd(sum4, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(sum2, _mm_unpackhi_pd(sum2, sum2)));
+}
+
+#endif
+
+// Tap counts with a kernel of their own, checked before anything else.
+static const struct
+{
+  size_t taps;
+  fir_kernel_t kernel;
+} FIXED_KERNELS[] = {
+#ifdef FIRKERNEL_X86
+  { 31, fir_avx2_fixed<31> },
+  { 61, fir_avx2_fixed<61> },
+  { 127, fir_avx2_fixed<127> },
+  { 255, fir_avx2_fixed<255> },
+#endif
+  { 0, NULL }
+};
+
+fir_kernel_t fir_kernel()
+{
+#ifdef FIRKERNEL_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return fir_avx2;
+  if (__builtin_cpu_supports("sse2"))
+    return fir_sse2;
+#endif
+  return fir_scalar;
+}
+
+fir_kernel_t fir_symmetric_kernel()
+{
+#ifdef FIRKERNEL_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return fir_symmetric_avx2;
+  if (__builtin_cpu_supports("sse2"))
+    return fir_symmetric_sse2;
+#endif
+  return fir_symmetric_scalar;
+}
+
+bool fir_is_symmetric(const std::vector<double> &coefficients)
+{
+  size_t n = coefficients.size();
+  double largest = 0.0;
+  for (size_t i = 0; i < n; i++)
+    largest = std::max(largest, std::fabs(coefficients[i]));
+  for (size_t i = 0; i < n / 2; i++) {
+    if (std::fabs(coefficients[i] - coefficients[n - 1 - i]) > 1e-12 * largest)
+      return false;
+  }
+  return true;
+}
+
+fir_kernel_t fir_fixed_kernel(size_t taps)
+{
+#ifdef FIRKERNEL_X86
+  __builtin_cpu_init();
+  if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma"))
+    return NULL;
+#endif
+  for (size_t i = 0; FIXED_KERNELS[i].kernel; i++) {
+    if (FIXED_KERNELS[i].taps == taps)
+      return FIXED_KERNELS[i].kernel;
+  }
+  return NULL;
+}
+
+fir_kernel_t fir_kernel(const std::vector<double> &coefficients)
+{
+  fir_kernel_t fixed = fir_fixed_kernel(coefficients.size());
+  if (fixed)
+    return fixed;
+  if (coefficients.size() >= SYMMETRIC_MIN_TAPS && 
+      fir_is_symmetric(coefficients))
+    return fir_symmetric_kernel();
+  return fir_kernel();
+}
@@ -0,0 +1,29 @@
+#ifndef FIRKERNEL_H
+#define FIRKERNEL_H
+
+#include <stddef.h>
+#include <vector>
+
+// Computes one FIR output: the sum of x[i] * h[i] for i from 0 to n - 1.
+typedef double (*fir_kernel_t)(const double *x, const double *h, size_t n);
+
+// The fastest kernel this CPU can run (AVX2, SSE2 or plain C++), picked the 
+// first time it's called. Call it from update(), not from the realtime thread.
+fir_kernel_t fir_kernel();
+
+// Same, but for a linear-phase filter, where h[i] == h[n - 1 - i]. It adds 
+// the two samples that share each coefficient first, so it does half the 
+// multiplies and only reads h[0] to h[n / 2].
+fir_kernel_t fir_symmetric_kernel();
+
+// A kernel unrolled for exactly |taps| taps, or NULL if there isn't one for 
+// that length on this CPU. It ignores its |n| argument.
+fir_kernel_t fir_fixed_kernel(size_t taps);
+
+// Whether |coefficients| are symmetric, to within rounding.
+bool fir_is_symmetric(const std::vector<double> &coefficients);
+
+// The best of the above for convolving with |coefficients|.
+fir_kernel_t fir_kernel(const std::vector<double> &coefficients);
+
+#endif /* end of include guard: FIRKERNEL_H */
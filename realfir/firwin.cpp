@@ -1,6 +1,7 @@
 #include <vector>
 #include <cmath>
 #include <iostream>
+#include "firwin.h"
 
 using namespace std;
 
@@ -10,8 +11,32 @@ inline double sinc(double x)
   return (x == 0.0 ? 1.0 : sin(M_PI * x) / (M_PI * x));
 }
 
+// Zeroth-order modified Bessel function of the first kind, by its power 
+// series; the terms shrink fast for any sensible beta.
+static double bessel_i0(double x)
+{
+  double sum = 1.0, term = 1.0;
+  for (int k = 1; term > 1e-16 * sum; k++) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+static double hamming(size_t i, size_t numtaps, double)
+{
+  return 0.54 - 0.46 * cos(2.0 * M_PI * i / (numtaps - 1));
+}
+
+static double kaiser(size_t i, size_t numtaps, double beta)
+{
+  double r = 2.0 * i / (numtaps - 1) - 1.0;
+  return bessel_i0(beta * sqrt(1.0 - r * r)) / bessel_i0(beta);
+}
+
 // Snipped from scipy 0.9.
-void firwin(vector<double> &coefficients, pair<double, double> &passband)
+static void firwin(vector<double> &coefficients, pair<double, double> &passband,
+                   double (*window)(size_t, size_t, double), double beta)
 {
   size_t numtaps = coefficients.size();
   double left    = passband.first, 
@@ -27,7 +52,7 @@ void firwin(vector<double> &coefficients, pair<double, double> &passband)
     double h2 = left * sinc(left * m);
     
     // Windowed.
-    double w = 0.54 - 0.46 * cos(2.0 * M_PI * i / (numtaps - 1));
+    double w = numtaps > 1 ? window(i, numtaps, beta) : 1.0;
     coefficients[i] = (h1 - h2) * w;
     
     // Bookkeeping for scaling.
@@ -39,3 +64,39 @@ void firwin(vector<double> &coefficients, pair<double, double> &passband)
     coefficients[i] /= accum;
   }
 }
+
+void firwin(vector<double> &coefficients, pair<double, double> &passband)
+{
+  firwin(coefficients, passband, hamming, 0.0);
+}
+
+void firwin(vector<double> &coefficients, pair<double, double> &passband, 
+            double beta)
+{
+  firwin(coefficients, passband, kaiser, beta);
+}
+
+double kaiser_beta(double attenuation)
+{
+  if (attenuation > 50.0)
+    return 0.1102 * (attenuation - 8.7);
+  if (attenuation > 21.0)
+    return 0.5842 * pow(attenuation - 21.0, 0.4) + 
+           0.07886 * (attenuation - 21.0);
+  return 0.0;
+}
+
+size_t kaiser_taps(double width, double attenuation)
+{
+  double taps = (attenuation - 7.95) / (2.285 * M_PI * width) + 1.0;
+  // Checked as a double, since a tiny width overflows a size_t.
+  if (!(taps < KAISER_MAX_TAPS))
+    return KAISER_MAX_TAPS;
+  size_t n = taps < 1.0 ? 1 : (size_t)ceil(taps);
+  return n % 2 ? n : n + 1;
+}
+
+double kaiser_width(size_t taps, double attenuation)
+{
+  return (attenuation - 7.95) / (2.285 * M_PI * (taps - 1.0));
+}
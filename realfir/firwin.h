@@ -15,4 +15,23 @@ using namespace std;
 // The size of |coefficients| is taken as the number of taps, and should be odd.
 void firwin(vector<double> &coefficients, pair<double, double> &passband);
 
+// Same, but with a Kaiser window of shape |beta| instead of Hamming's. Use 
+// kaiser_beta and kaiser_taps to meet a specification.
+void firwin(vector<double> &coefficients, pair<double, double> &passband, 
+            double beta);
+
+// The Kaiser window shape that keeps the stopband |attenuation| dB down.
+double kaiser_beta(double attenuation);
+
+// The fewest taps (odd) for a Kaiser window filter whose transition bands are 
+// |width| wide, normalized like |passband|, with stopband |attenuation| dB 
+// down. From Kaiser's order estimate, as in scipy's kaiserord. Never more 
+// than KAISER_MAX_TAPS, however narrow |width|.
+#define KAISER_MAX_TAPS 1000001
+size_t kaiser_taps(double width, double attenuation);
+
+// The narrowest transition width |taps| taps can meet at |attenuation| dB, 
+// the other way around from kaiser_taps.
+double kaiser_width(size_t taps, double attenuation);
+
 #endif /* end of include guard: FIRWIN_H */
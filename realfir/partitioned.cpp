@@ -0,0 +1,142 @@
+#include "partitioned.h"
+
+#include <algorithm>
+
+// How long the helper naps when it's caught up.
+#define POLL_MS 1
+
+PartitionedFIR::PartitionedFIR(const vector<double> &coefficients, 
+                               size_t blockSize, double &lateBlocks) :
+  B(blockSize), block(0), pos(0), tailReady(false), late(lateBlocks),
+  inBlocks(BLOCK_SLOTS * blockSize), outBlocks(BLOCK_SLOTS * blockSize),
+  blocksIn(0), blocksOut(0), validFrom(0), bail(false), fft(2 * blockSize), 
+  work(2 * blockSize), previous(blockSize)
+{
+  size_t headTaps = min(2 * B, coefficients.size());
+  headCoefficients.assign(coefficients.begin(), 
+                          coefficients.begin() + headTaps);
+  head.resize(headTaps);
+  // The delay line is oldest first, so the direct part runs backwards.
+  reverse(headCoefficients.begin(), headCoefficients.end());
+  headKernel = fir_kernel();
+
+  size_t tail = coefficients.size() - headTaps;
+  P = (tail + B - 1) / B;
+  partitions.assign(P * (B + 1), complex<double>(0.0, 0.0));
+  history.assign(P * (B + 1), complex<double>(0.0, 0.0));
+  for (size_t p = 0; p < P; p++) {
+    fill(work.begin(), work.end(), complex<double>(0.0, 0.0));
+    for (size_t i = 0; i < B && headTaps + p * B + i < coefficients.size(); i++)
+      work[i] = coefficients[headTaps + p * B + i];
+    fft.forward(&work[0]);
+    copy(work.begin(), work.begin() + B + 1, partitions.begin() + p * (B + 1));
+  }
+}
+
+PartitionedFIR::~PartitionedFIR()
+{
+  bail = true;
+  wait();
+}
+
+double PartitionedFIR::filter(double sample)
+{
+  head.push(sample);
+  double y = headKernel(head.samples(), &headCoefficients[0], head.size());
+
+  // The helper's output for input block |block - 2| belongs to this block. 
+  // Check for it once, as the block starts.
+  if (pos == 0) {
+    tailReady = block >= 2 && blocksOut >= block - 1;
+    __sync_synchronize();
+    tailReady = tailReady && block - 2 >= validFrom;
+    if (block >= 2 && !tailReady)
+      late++;
+  }
+  if (tailReady)
+    y += outBlocks[((block - 2) % BLOCK_SLOTS) * B + pos];
+
+  inBlocks[(block % BLOCK_SLOTS) * B + pos] = sample;
+  if (++pos == B) {
+    __sync_synchronize();
+    blocksIn = ++block;
+    pos = 0;
+  }
+  return y;
+}
+
+void PartitionedFIR::run()
+{
+  while (!bail) {
+    size_t done = blocksOut;
+    if (done == blocksIn) {
+      msleep(POLL_MS);
+      continue;
+    }
+    __sync_synchronize();
+    if (blocksIn - done >= BLOCK_SLOTS || !processBlock(done)) {
+      // Too late: the realtime thread has started reusing the slot. Pick up 
+      // from the newest whole block instead. If even that's gone by the time
+      // it's read, go around again.
+      done = blocksIn - 1;
+      restart(done);
+      __sync_synchronize();
+      if (!processBlock(done))
+        continue;
+    }
+    __sync_synchronize();
+    blocksOut = done + 1;
+  }
+}
+
+// Forget the input so far. Tail outputs need the P blocks before them as 
+// well, so none are complete until there have been P more.
+void PartitionedFIR::restart(size_t n)
+{
+  fill(history.begin(), history.end(), complex<double>(0.0, 0.0));
+  fill(previous.begin(), previous.end(), 0.0);
+  validFrom = n + P;
+}
+
+// Overlap-save: transform the last two blocks of input, multiply by each 
+// partition's spectrum against the input from that many blocks ago, and 
+// transform back. The second half is the tail's output for this block. 
+// Returns false, having changed nothing, if the input was overwritten while 
+// it was being read.
+bool PartitionedFIR::processBlock(size_t n)
+{
+  const double *in = &inBlocks[(n % BLOCK_SLOTS) * B];
+  for (size_t i = 0; i < B; i++)
+    work[B + i] = in[i];
+  // The realtime thread writes block n + BLOCK_SLOTS into the same slot, 
+  // starting as soon as blocksIn gets there.
+  __sync_synchronize();
+  if (blocksIn - n >= BLOCK_SLOTS)
+    return false;
+  for (size_t i = 0; i < B; i++) {
+    work[i] = previous[i];
+    previous[i] = work[B + i].real();
+  }
+  fft.forward(&work[0]);
+
+  size_t newest = n % P;
+  copy(work.begin(), work.begin() + B + 1, 
+       history.begin() + newest * (B + 1));
+
+  fill(work.begin(), work.end(), complex<double>(0.0, 0.0));
+  for (size_t p = 0; p < P; p++) {
+    const complex<double> *x = &history[((newest + P - p) % P) * (B + 1)];
+    const complex<double> *h = &partitions[p * (B + 1)];
+    for (size_t k = 0; k <= B; k++)
+      work[k] += x[k] * h[k];
+  }
+  for (size_t k = 1; k < B; k++)
+    work[2 * B - k] = conj(work[k]);
+  fft.inverse(&work[0]);
+
+  double *out = &outBlocks[(n % BLOCK_SLOTS) * B];
+  double scale = 1.0 / (2 * B);
+  for (size_t i = 0; i < B; i++)
+    out[i] = work[B + i].real() * scale;
+  return true;
+}
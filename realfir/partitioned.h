@@ -0,0 +1,72 @@
+#ifndef PARTITIONED_H
+#define PARTITIONED_H
+
+#include <complex>
+#include <vector>
+
+#include <qthread.h>
+
+#include "delayline.h"
+#include "fft.h"
+#include "firkernel.h"
+
+using namespace std;
+
+// A long FIR filter, split between the realtime thread and a helper thread.
+//
+// The realtime thread convolves the first two blocks' worth of taps directly, 
+// so every output is on time. The rest of the taps are cut into block-sized 
+// partitions and applied by the helper thread with FFTs (uniformly 
+// partitioned overlap-save), a block of input at a time. Its results aren't 
+// needed until a whole block after the input they depend on is complete, 
+// which is the helper's deadline. If it misses one, that block's output only 
+// has the direct part, and |late| is incremented.
+//
+// If the helper falls so far behind that the realtime thread reuses an input 
+// slot it hasn't read yet, it skips ahead to the newest block and starts the 
+// tail over with no history. Tail outputs that would have needed the skipped 
+// input are left out and counted as late too.
+class PartitionedFIR : public QThread
+{
+public:
+  PartitionedFIR(const vector<double> &coefficients, size_t blockSize, 
+                 double &late);
+  virtual ~PartitionedFIR();
+
+  // Realtime thread: take one sample, return one output.
+  double filter(double sample);
+
+  virtual void run();
+
+private:
+  bool processBlock(size_t block);
+  void restart(size_t block);
+
+  size_t B;  // block size
+  size_t P;  // partitions handled by the helper
+
+  // Realtime side.
+  DelayLine head;
+  vector<double> headCoefficients;
+  fir_kernel_t headKernel;
+  size_t block, pos;
+  bool tailReady;
+  double &late;
+
+  // Handed between the threads. Slots are reused every BLOCK_SLOTS blocks. 
+  // Tail outputs from before block |validFrom| are incomplete.
+  enum { BLOCK_SLOTS = 4 };
+  vector<double> inBlocks, outBlocks;
+  volatile size_t blocksIn, blocksOut;
+  volatile size_t validFrom;
+  volatile bool bail;
+
+  // Helper side. Spectra only keep bins 0 to B; the rest mirror them.
+  FFT fft;
+  vector<complex<double> > partitions;  // P spectra of the tail taps
+  vector<complex<double> > history;     // P spectra of recent input windows
+  vector<complex<double> > work;
+  vector<double> previous;
+};
+
+#endif /* end of include guard: PARTITIONED_H */
@@ -1,5 +1,6 @@
 
 #include <realfir.h>
+#include "designer.h"
 #include "firwin.h"
 
 extern "C" Plugin::Object *createRTXIPlugin(void) {
@@ -10,11 +11,23 @@ extern "C" Plugin::Object *createRTXIPlugin(void) {
 #define PARAM_PASSBAND_HIGH "High end of passband (Hz)"
 #define PARAM_SAMPLING_RATE "Sampling rate (Hz)"
 #define PARAM_FILTER_TAPS "Number of filter taps"
+#define PARAM_TRANSITION_WIDTH "Transition width (Hz)"
+#define PARAM_ATTENUATION "Stopband attenuation (dB)"
+#define PARAM_INTERPOLATE "Interpolate output"
+#define PARAM_CROSSFADE "Crossfade (s)"
+#define STATE_LATE_BLOCKS "Late FFT blocks"
 
 #define INITIAL_PASSBAND_LOW 5
 #define INITIAL_PASSBAND_HIGH 25
 #define INITIAL_SAMPLING_RATE 1000.0
 #define INITIAL_FILTER_TAPS 61
+#define INITIAL_TRANSITION_WIDTH 0.0
+#define INITIAL_ATTENUATION 60.0
+#define INITIAL_INTERPOLATE 0
+#define INITIAL_CROSSFADE 0.0
+
+// Filtered samples that go into each interpolated output.
+#define INTERPOLATION_TAPS 8
 
 static DefaultGUIModel::variable_t vars[] = {
   {
@@ -46,48 +59,167 @@ static DefaultGUIModel::variable_t vars[] = {
   {
     PARAM_FILTER_TAPS,
     "Number of taps (coefficients) in the filter. More taps means sharper "
-    "cutoff but slower execution",
+    "cutoff but slower execution. Worked out for you if there's a transition "
+    "width",
     DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
   },
+  {
+    PARAM_TRANSITION_WIDTH,
+    "How quickly the response must fall from passband to stopband (Hz). If "
+    "set, the filter uses a Kaiser window and just enough taps to meet this "
+    "and the stopband attenuation. Zero to set the taps yourself",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_ATTENUATION,
+    "How far down the stopband must be (dB), when there's a transition width",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_INTERPOLATE,
+    "1 to smoothly interpolate the output between samples, 0 to hold each "
+    "output until the next sample. Interpolating adds a few samples' delay",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+  },
+  {
+    PARAM_CROSSFADE,
+    "When the filter changes, fade from the old one to the new one over this "
+    "long (s). Zero switches straight over",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    STATE_LATE_BLOCKS,
+    "Blocks of output that went out without the long filter's tail, because "
+    "its FFT thread fell behind",
+    DefaultGUIModel::STATE,
+  },
+  EXECTIME_VARS
 };
 
 static size_t num_vars = sizeof(vars)/sizeof(DefaultGUIModel::variable_t);
 
-RealFIR::RealFIR(void) : DefaultGUIModel("RealFIR", ::vars, ::num_vars) {
+RealFIR::RealFIR(void) : DefaultGUIModel("RealFIR", ::vars, ::num_vars),
+  filtered(0.0), lateBlocks(0), active(NULL), fading(NULL), fadeLength(0), 
+  fadeLeft(0), interpolate(false), phaseCount(0), samplingRate(0.0), 
+  sampleTicks(1), lastSample(0) {
+  designer = new FilterDesigner(lateBlocks);
+  
   // Set defaults for each parameter.
   setParameter(PARAM_PASSBAND_LOW, INITIAL_PASSBAND_LOW);
   setParameter(PARAM_PASSBAND_HIGH, INITIAL_PASSBAND_HIGH);
   setParameter(PARAM_SAMPLING_RATE, INITIAL_SAMPLING_RATE);
   setParameter(PARAM_FILTER_TAPS, INITIAL_FILTER_TAPS);
+  setParameter(PARAM_TRANSITION_WIDTH, INITIAL_TRANSITION_WIDTH);
+  setParameter(PARAM_ATTENUATION, INITIAL_ATTENUATION);
+  setParameter(PARAM_INTERPOLATE, INITIAL_INTERPOLATE);
+  setParameter(PARAM_CROSSFADE, INITIAL_CROSSFADE);
   
-  // Get the coefficients for the defaults, and the realtime period.
-  update(MODIFY);
+  // Get the realtime period, and the coefficients for the defaults.
   update(PERIOD);
+  update(MODIFY);
+  designer->wait();
+  setState(STATE_LATE_BLOCKS, lateBlocks);
+  EXECTIME_INIT;
   
   refresh();
 }
 
-RealFIR::~RealFIR(void) {}
+RealFIR::~RealFIR(void) {
+  delete designer;
+}
 
 void RealFIR::execute(void) {
-  elapsedTime += dt_s;
+  EXECTIME_SCOPE;
+  clock.tick();
   
-  // Grab a sample if we need it.
-  if (elapsedTime - lastSample >= 1.0 / samplingRate)
+  // Switch to a newly designed filter. If both are direct, the new one 
+  // carries on with as much of the old one's history as it has room for.
+  FilterBank *next = designer->takeFilter();
+  if (next)
   {
-    buffer.push_back(input(0));
-    lastSample = elapsedTime;
+    if (active && !active->partitioned && !next->partitioned)
+      next->line.copyHistory(active->line);
+    fading = fadeLength > 0 ? active : NULL;
+    fadeLeft = fadeLength;
+    active = next;
   }
   
-  // Convolve.
-  accum = 0;
-  for (i = 0; i < buffer.size(); i++)
-    accum += buffer[i] * coefficients[i];
-  output(0) = accum;
+  // Grab a sample if we need it, and convolve. Between samples the output 
+  // doesn't change, so there's nothing to recompute.
+  if (clock.now() - lastSample >= sampleTicks)
+  {
+    double sample = input(0);
+    filtered = active ? active->filter(sample) : 0.0;
+    if (fading)
+    {
+      double mix = (double)fadeLeft / fadeLength;
+      filtered += mix * (fading->filter(sample) - filtered);
+      if (--fadeLeft == 0)
+        fading = NULL;
+    }
+    lastSample = clock.now();
+    if (interpolate)
+    {
+      history.push(filtered);
+      phase = 0;
+    }
+  }
+  
+  if (!interpolate)
+  {
+    output(0) = filtered;
+    return;
+  }
+  
+  output(0) = interpolationKernel(history.samples(), 
+                                  &phases[phase * INTERPOLATION_TAPS], 
+                                  INTERPOLATION_TAPS);
+  if (phase < phaseCount - 1)
+    phase++;
+}
+
+// Interpolating up by some factor L is the same as inserting L - 1 zeroes 
+// after every sample and lowpass filtering at the higher rate. Most of those 
+// multiplies would be by zero, so instead the lowpass is split into L phases, 
+// each only the coefficients that line up with real samples at that point 
+// between them.
+void RealFIR::designInterpolator(void) {
+  // One phase per realtime period between samples.
+  size_t count = (size_t)sampleTicks;
+  bool enable = getParameter(PARAM_INTERPOLATE).toUInt() && count > 1;
+  // Nothing's changed, so keep the interpolator's history.
+  if (count == phaseCount && enable == interpolate)
+    return;
+  phaseCount = count;
+  interpolate = enable;
+  history.resize(INTERPOLATION_TAPS);
+  phase = 0;
+  if (!interpolate)
+    return;
+  
+  vector<double> lowpass(phaseCount * INTERPOLATION_TAPS);
+  std::pair<double, double> band(0.0, 1.0 / phaseCount);
+  firwin(lowpass, band);
+  
+  // History is oldest first, so each phase is stored back to front. Each is 
+  // scaled to unity gain so a constant input comes out without ripple.
+  phases.resize(lowpass.size());
+  for (size_t p = 0; p < phaseCount; p++) {
+    double *h = &phases[p * INTERPOLATION_TAPS];
+    double sum = 0.0;
+    for (size_t k = 0; k < INTERPOLATION_TAPS; k++) {
+      h[INTERPOLATION_TAPS - 1 - k] = lowpass[p + k * phaseCount];
+      sum += lowpass[p + k * phaseCount];
+    }
+    for (size_t k = 0; k < INTERPOLATION_TAPS; k++)
+      h[k] /= sum;
+  }
+  interpolationKernel = fir_kernel();
 }
 
 void RealFIR::update(DefaultGUIModel::update_flags_t flag) {
   size_t taps;
+  double width, attenuation, beta;
   switch(flag) {
     // Cut output on pause; it'll restart in execute() on unpause.
     case PAUSE:
@@ -97,23 +229,41 @@ void RealFIR::update(DefaultGUIModel::update_flags_t flag) {
     // Grab the new parameters and make a new filter.
     case MODIFY:
       samplingRate = getParameter(PARAM_SAMPLING_RATE).toDouble();
+      sampleTicks = clock.ticks(1.0 / samplingRate);
       passband = std::make_pair(getParameter(PARAM_PASSBAND_LOW).toDouble(), 
                                 getParameter(PARAM_PASSBAND_HIGH).toDouble());
       passband.first /= samplingRate / 2.0;
       passband.second /= samplingRate / 2.0;
       taps = getParameter(PARAM_FILTER_TAPS).toUInt();
-      // Ensure an odd number of taps.
-      coefficients.resize(taps + ((taps % 2 == 0) ? 1 : 0));
-      firwin(coefficients, passband);
-      // Size and zero the buffer.
-      buffer.clear();
-      buffer.resize(coefficients.size());
-      lastSample = elapsedTime = 0.0;
+      // Spec-driven: as few taps as meet the transition width and 
+      // attenuation, shown in place of the tap count.
+      width = getParameter(PARAM_TRANSITION_WIDTH).toDouble();
+      attenuation = getParameter(PARAM_ATTENUATION).toDouble();
+      beta = -1.0;
+      if (width > 0.0) {
+        taps = kaiser_taps(width / (samplingRate / 2.0), attenuation);
+        // Past the longest filter allowed, show the width it can manage.
+        if (taps == KAISER_MAX_TAPS) {
+          width = kaiser_width(taps, attenuation) * samplingRate / 2.0;
+          setParameter(PARAM_TRANSITION_WIDTH, width);
+        }
+        beta = kaiser_beta(attenuation);
+        setParameter(PARAM_FILTER_TAPS, QString::number((unsigned int)taps));
+      }
+      fadeLength = (size_t)(getParameter(PARAM_CROSSFADE).toDouble() * 
+                            samplingRate);
+      // The realtime thread keeps running the old filter until the new one 
+      // is ready.
+      designer->design(passband, taps, samplingRate, beta);
+      designInterpolator();
       break;
     
-    // Grab the realtime period in seconds.
+    // Grab the realtime period, and how many periods go by between samples.
     case PERIOD:
-      dt_s = RT::System::getInstance()->getPeriod() * 1e-9;
+      clock.update();
+      sampleTicks = clock.ticks(1.0 / samplingRate);
+      if (samplingRate > 0.0)
+        designInterpolator();
       break;
     
     default:
@@ -1,13 +1,19 @@
 /*
  * RealFIR
- * Low/high/band-pass FIR filter, designed from a Hamming window.
+ * Low/high/band-pass FIR filter, designed from a Hamming or Kaiser window.
  * Copyright 2011 Nolan Waite
  */
 
 
 #include <default_gui_model.h>
+#include "../common/exectime.h"
+#include "../common/timebase.h"
+#include "delayline.h"
+#include "firkernel.h"
 #include <vector>
-#include <boost/circular_buffer.hpp>
+
+struct FilterBank;
+class FilterDesigner;
 
 
 class RealFIR : public DefaultGUIModel
@@ -26,14 +32,35 @@ protected:
 
 private:
 
-    std::vector<double> coefficients;
+    void designInterpolator(void);
+
     std::pair<double, double> passband;
-    boost::circular_buffer<double> buffer;
+    double filtered;
+    double lateBlocks;
+    
+    // Filters are designed off the realtime thread and picked up from here 
+    // (see designer.h). After a change, the old filter can be crossfaded out.
+    FilterDesigner *designer;
+    FilterBank *active;
+    FilterBank *fading;
+    size_t fadeLength;
+    size_t fadeLeft;
+    
+    // Interpolation from the sampling rate up to the realtime rate: the last 
+    // few filtered samples, and one set of coefficients per realtime period 
+    // between samples, one after the other.
+    bool interpolate;
+    DelayLine history;
+    std::vector<double> phases;
+    size_t phaseCount;
+    size_t phase;
+    fir_kernel_t interpolationKernel;
+    
     double samplingRate;
-    double lastSample;
-    double dt_s;
-    double elapsedTime;
-    double accum;
-    size_t i;
+    uint64_t sampleTicks;
+    uint64_t lastSample;
+    Timebase clock;
+
+    EXECTIME_DECLARE;
 
 };
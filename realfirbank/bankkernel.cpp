@@ -0,0 +1,87 @@
+#include "bankkernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BANKKERNEL_X86
+#endif
+
+// Vectors as wide as each target's registers: SSE2, AVX and AVX-512. 
+// Wider ones than the target has get spilled to the stack, so a frame is 
+// split into however many of these it takes.
+typedef double v2df __attribute__((vector_size(16)));
+typedef double v4df __attribute__((vector_size(32)));
+typedef double v8df __attribute__((vector_size(64)));
+
+template <typename V>
+static inline __attribute__((always_inline)) 
+void multiply_add(V &sum, const double *x, double h)
+{
+  V v;
+  __builtin_memcpy(&v, x, sizeof(v));
+  sum += v * h;
+}
+
+// Each coefficient is loaded once and applied to every channel. Four 
+// independent sums per part of the frame, so each multiply-add doesn't wait 
+// on the last.
+template <typename V>
+static inline __attribute__((always_inline))
+void bank_convolve(const double *x, const double *h, size_t n, double *out)
+{
+  enum { LANES = sizeof(V) / sizeof(double), PARTS = BANK_CHANNELS / LANES };
+  V a0[PARTS], a1[PARTS], a2[PARTS], a3[PARTS];
+  for (size_t p = 0; p < PARTS; p++)
+    a0[p] = a1[p] = a2[p] = a3[p] = V() * 0.0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const double *f = x + i * BANK_CHANNELS;
+    for (size_t p = 0; p < PARTS; p++) {
+      multiply_add(a0[p], f + p * LANES, h[i]);
+      multiply_add(a1[p], f + BANK_CHANNELS + p * LANES, h[i + 1]);
+      multiply_add(a2[p], f + 2 * BANK_CHANNELS + p * LANES, h[i + 2]);
+      multiply_add(a3[p], f + 3 * BANK_CHANNELS + p * LANES, h[i + 3]);
+    }
+  }
+  for (; i < n; i++) {
+    for (size_t p = 0; p < PARTS; p++)
+      multiply_add(a0[p], x + i * BANK_CHANNELS + p * LANES, h[i]);
+  }
+  for (size_t p = 0; p < PARTS; p++) {
+    V sum = (a0[p] + a1[p]) + (a2[p] + a3[p]);
+    __builtin_memcpy(out + p * LANES, &sum, sizeof(sum));
+  }
+}
+
+static void bank_generic(const double *x, const double *h, size_t n, 
+                         double *out)
+{
+  bank_convolve<v2df>(x, h, n, out);
+}
+
+#ifdef BANKKERNEL_X86
+
+__attribute__((target("avx2,fma")))
+static void bank_avx2(const double *x, const double *h, size_t n, double *out)
+{
+  bank_convolve<v4df>(x, h, n, out);
+}
+
+__attribute__((target("avx512f")))
+static void bank_avx512(const double *x, const double *h, size_t n, 
+                        double *out)
+{
+  bank_convolve<v8df>(x, h, n, out);
+}
+
+#endif
+
+bank_kernel_t bank_kernel()
+{
+#ifdef BANKKERNEL_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return bank_avx512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return bank_avx2;
+#endif
+  return bank_generic;
+}
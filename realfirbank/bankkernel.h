@@ -0,0 +1,19 @@
+#ifndef BANKKERNEL_H
+#define BANKKERNEL_H
+
+#include <stddef.h>
+
+// Channels filtered side by side, one per SIMD lane.
+#define BANK_CHANNELS 8
+
+// Computes one FIR output for each of BANK_CHANNELS channels: out[c] is the 
+// sum of x[i * BANK_CHANNELS + c] * h[i] for i from 0 to n - 1, where |x| is 
+// n interleaved frames (see frameline.h).
+typedef void (*bank_kernel_t)(const double *x, const double *h, size_t n, 
+                              double *out);
+
+// The fastest kernel this CPU can run (AVX-512, AVX2 or plain vectors). Call 
+// it from update(), not from the realtime thread.
+bank_kernel_t bank_kernel();
+
+#endif /* end of include guard: BANKKERNEL_H */
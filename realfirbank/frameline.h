@@ -0,0 +1,47 @@
+/*
+ * FrameLine
+ * The last N frames of several signals, interleaved and always contiguous.
+ */
+
+#ifndef FRAMELINE_H
+#define FRAMELINE_H
+
+#include <string.h>
+#include <vector>
+
+// A DelayLine (see ../realfir/delayline.h) whose samples are frames of 
+// |width| channels, one after the other. Tap i of every channel is then in 
+// one place, so a kernel can load them all at once.
+class FrameLine
+{
+public:
+  FrameLine(size_t aWidth) : pos(0), length(0), width(aWidth) {}
+
+  // Forget everything and hold |n| frames of zeroes.
+  void resize(size_t n)
+  {
+    length = n;
+    line.assign(2 * n * width, 0.0);
+    pos = 0;
+  }
+
+  void push(const double *frame)
+  {
+    memcpy(&line[pos * width], frame, width * sizeof(double));
+    memcpy(&line[(pos + length) * width], frame, width * sizeof(double));
+    if (++pos == length)
+      pos = 0;
+  }
+
+  // The last size() frames, oldest first.
+  const double *frames() const { return &line[pos * width]; }
+  size_t size() const { return length; }
+
+private:
+  std::vector<double> line;
+  size_t pos;
+  size_t length;
+  size_t width;
+};
+
+#endif /* end of include guard: FRAMELINE_H */
@@ -0,0 +1,240 @@
+#include <realfirbank.h>
+#include <string.h>
+#include <algorithm>
+#include "../realfir/coefcache.h"
+#include "../realfir/firwin.h"
+
+extern "C" Plugin::Object *createRTXIPlugin(void) {
+    return new RealFIRBank();
+}
+
+#define PARAM_PASSBAND_LOW "Low end of passband (Hz)"
+#define PARAM_PASSBAND_HIGH "High end of passband (Hz)"
+#define PARAM_SAMPLING_RATE "Sampling rate (Hz)"
+#define PARAM_FILTER_TAPS "Number of filter taps"
+#define PARAM_TRANSITION_WIDTH "Transition width (Hz)"
+#define PARAM_ATTENUATION "Stopband attenuation (dB)"
+
+#define INITIAL_PASSBAND_LOW 5
+#define INITIAL_PASSBAND_HIGH 25
+#define INITIAL_SAMPLING_RATE 1000.0
+#define INITIAL_FILTER_TAPS 61
+#define INITIAL_TRANSITION_WIDTH 0.0
+#define INITIAL_ATTENUATION 60.0
+
+static DefaultGUIModel::variable_t vars[] = {
+  {
+    "Vin 1",
+    "Input signal 1",
+    DefaultGUIModel::INPUT,
+  },
+  {
+    "Vin 2",
+    "Input signal 2",
+    DefaultGUIModel::INPUT,
+  },
+  {
+    "Vin 3",
+    "Input signal 3",
+    DefaultGUIModel::INPUT,
+  },
+  {
+    "Vin 4",
+    "Input signal 4",
+    DefaultGUIModel::INPUT,
+  },
+  {
+    "Vin 5",
+    "Input signal 5",
+    DefaultGUIModel::INPUT,
+  },
+  {
+    "Vin 6",
+    "Input signal 6",
+    DefaultGUIModel::INPUT,
+  },
+  {
+    "Vin 7",
+    "Input signal 7",
+    DefaultGUIModel::INPUT,
+  },
+  {
+    "Vin 8",
+    "Input signal 8",
+    DefaultGUIModel::INPUT,
+  },
+  {
+    "Vout 1 (filtered)",
+    "Filtered input signal 1",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Vout 2 (filtered)",
+    "Filtered input signal 2",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Vout 3 (filtered)",
+    "Filtered input signal 3",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Vout 4 (filtered)",
+    "Filtered input signal 4",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Vout 5 (filtered)",
+    "Filtered input signal 5",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Vout 6 (filtered)",
+    "Filtered input signal 6",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Vout 7 (filtered)",
+    "Filtered input signal 7",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    "Vout 8 (filtered)",
+    "Filtered input signal 8",
+    DefaultGUIModel::OUTPUT,
+  },
+  {
+    PARAM_PASSBAND_LOW,
+    "Attenuate frequencies below this frequency",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_PASSBAND_HIGH,
+    "Attenuate frequencies above this frequency",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_SAMPLING_RATE,
+    "Sample the input signals this often (Hz). Make this at least double the "
+    "highest frequency you wish to filter",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_FILTER_TAPS,
+    "Number of taps (coefficients) in the filter. More taps means sharper "
+    "cutoff but slower execution. Worked out for you if there's a transition "
+    "width",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+  },
+  {
+    PARAM_TRANSITION_WIDTH,
+    "How quickly the response must fall from passband to stopband (Hz). If "
+    "set, the filter uses a Kaiser window and just enough taps to meet this "
+    "and the stopband attenuation. Zero to set the taps yourself",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  {
+    PARAM_ATTENUATION,
+    "How far down the stopband must be (dB), when there's a transition width",
+    DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+  },
+  EXECTIME_VARS
+};
+
+static size_t num_vars = sizeof(vars)/sizeof(DefaultGUIModel::variable_t);
+
+RealFIRBank::RealFIRBank(void) : 
+  DefaultGUIModel("RealFIR Bank", ::vars, ::num_vars),
+  kernel(bank_kernel()), line(BANK_CHANNELS), samplingRate(0.0), 
+  sampleTicks(1), lastSample(0) {
+  memset(filtered, 0, sizeof(filtered));
+  
+  // Set defaults for each parameter.
+  setParameter(PARAM_PASSBAND_LOW, INITIAL_PASSBAND_LOW);
+  setParameter(PARAM_PASSBAND_HIGH, INITIAL_PASSBAND_HIGH);
+  setParameter(PARAM_SAMPLING_RATE, INITIAL_SAMPLING_RATE);
+  setParameter(PARAM_FILTER_TAPS, INITIAL_FILTER_TAPS);
+  setParameter(PARAM_TRANSITION_WIDTH, INITIAL_TRANSITION_WIDTH);
+  setParameter(PARAM_ATTENUATION, INITIAL_ATTENUATION);
+  
+  // Get the realtime period, and the coefficients for the defaults.
+  update(PERIOD);
+  update(MODIFY);
+  EXECTIME_INIT;
+  
+  refresh();
+}
+
+RealFIRBank::~RealFIRBank(void) {}
+
+void RealFIRBank::execute(void) {
+  EXECTIME_SCOPE;
+  clock.tick();
+  
+  // Grab a frame if we need it, and convolve every channel in one pass over 
+  // the coefficients. Between samples the output doesn't change.
+  if (clock.now() - lastSample >= sampleTicks)
+  {
+    for (size_t c = 0; c < BANK_CHANNELS; c++)
+      frame[c] = input(c);
+    line.push(frame);
+    kernel(line.frames(), &coefficients[0], line.size(), filtered);
+    lastSample = clock.now();
+  }
+  
+  for (size_t c = 0; c < BANK_CHANNELS; c++)
+    output(c) = filtered[c];
+}
+
+// The same designs as RealFIR's, from the same cache.
+void RealFIRBank::design(size_t taps, double beta) {
+  design_coefficients(coefficients, passband, taps, samplingRate, beta);
+  std::reverse(coefficients.begin(), coefficients.end());
+  line.resize(coefficients.size());
+}
+
+void RealFIRBank::update(DefaultGUIModel::update_flags_t flag) {
+  size_t taps;
+  double width, attenuation, beta;
+  switch(flag) {
+    // Cut output on pause; it'll restart in execute() on unpause.
+    case PAUSE:
+      for (size_t c = 0; c < BANK_CHANNELS; c++)
+        output(c) = 0;
+      break;
+    
+    // Grab the new parameters and make a new filter.
+    case MODIFY:
+      samplingRate = getParameter(PARAM_SAMPLING_RATE).toDouble();
+      sampleTicks = clock.ticks(1.0 / samplingRate);
+      passband = std::make_pair(getParameter(PARAM_PASSBAND_LOW).toDouble(), 
+                                getParameter(PARAM_PASSBAND_HIGH).toDouble());
+      passband.first /= samplingRate / 2.0;
+      passband.second /= samplingRate / 2.0;
+      taps = getParameter(PARAM_FILTER_TAPS).toUInt();
+      // Spec-driven, as in RealFIR.
+      width = getParameter(PARAM_TRANSITION_WIDTH).toDouble();
+      attenuation = getParameter(PARAM_ATTENUATION).toDouble();
+      beta = -1.0;
+      if (width > 0.0) {
+        taps = kaiser_taps(width / (samplingRate / 2.0), attenuation);
+        if (taps == KAISER_MAX_TAPS) {
+          width = kaiser_width(taps, attenuation) * samplingRate / 2.0;
+          setParameter(PARAM_TRANSITION_WIDTH, width);
+        }
+        beta = kaiser_beta(attenuation);
+        setParameter(PARAM_FILTER_TAPS, QString::number((unsigned int)taps));
+      }
+      design(taps, beta);
+      break;
+    
+    // Grab the realtime period, and how many periods go by between samples.
+    case PERIOD:
+      clock.update();
+      sampleTicks = clock.ticks(1.0 / samplingRate);
+      break;
+    
+    default:
+      break;
+  }
+}
@@ -0,0 +1,50 @@
+/*
+ * RealFIRBank
+ * RealFIR on eight channels at once, all through the same filter.
+ */
+
+
+#include <default_gui_model.h>
+#include "../common/exectime.h"
+#include "../common/timebase.h"
+#include "bankkernel.h"
+#include "frameline.h"
+#include <vector>
+
+
+class RealFIRBank : public DefaultGUIModel
+{
+
+public:
+
+    RealFIRBank(void);
+    virtual ~RealFIRBank(void);
+
+    void execute(void);
+
+protected:
+
+    void update(DefaultGUIModel::update_flags_t);
+
+private:
+
+    void design(size_t taps, double beta);
+
+    std::pair<double, double> passband;
+    
+    // One set of coefficients, stored back to front since frames are oldest 
+    // first, and one interleaved delay line for every channel.
+    std::vector<double> coefficients;
+    bank_kernel_t kernel;
+    FrameLine line;
+    double frame[BANK_CHANNELS];
+    double filtered[BANK_CHANNELS];
+    
+    double samplingRate;
+    uint64_t sampleTicks;
+    uint64_t lastSample;
+    Timebase clock;
+
+    EXECTIME_DECLARE;
+
+};
@@ -52,6 +52,7 @@ extern "C" Plugin::Object *createRTXIPlugin()
 }
 
 #define PARAM_SAMPLE_RATE "Sample rate (Hz)"
+#define STATE_UNDERRUNS "Underruns"
 
 #define INITIAL_SAMPLE_RATE 50
 
@@ -67,6 +68,12 @@ static SamplePlayer::variable_t vars[] =
     "How often to output a new sample",
     SamplePlayer::PARAMETER | SamplePlayer::DOUBLE,
   },
+  {
+    STATE_UNDERRUNS,
+    "Periods that had no sample because the file couldn't be read fast enough",
+    SamplePlayer::STATE,
+  },
+  EXECTIME_VARS
 };
 
 static size_t num_vars = sizeof(vars) / sizeof(SamplePlayer::variable_t);
@@ -74,7 +81,7 @@ static size_t num_vars = sizeof(vars) / sizeof(SamplePlayer::variable_t);
 SamplePlayer::SamplePlayer(void) :
 	QWidget(MainWindow::getInstance()->centralWidget()), 
 	Workspace::Instance("SamplePlayer", vars, num_vars),
-	worker(NULL), askedForMore(false)
+	window(NULL), windowPos(0), worker(NULL), underruns(0)
 {
 	setCaption(QString::number(getID()) + " SamplePlayer");
 
@@ -170,6 +177,8 @@ SamplePlayer::SamplePlayer(void) :
 
 	update(INIT);
 	update(PERIOD);
+	setState(STATE_UNDERRUNS, underruns);
+	EXECTIME_INIT;
 	refresh();
 }
 
@@ -177,30 +186,41 @@ SamplePlayer::~SamplePlayer(void)
 {
   if (worker)
   {
-    worker->terminate();
+    worker->bail();
     worker->wait();
     delete worker;
     worker = NULL;
   }
+  delete window;
 }
 
 void SamplePlayer::execute(void)
 {
-  elapsedTime += dt_s;
-  if (!askedForMore && worker != NULL && sampleQueue.size() < sampleRate * 2.0)
+  EXECTIME_SCOPE;
+  clock.tick();
+  if (clock.now() - lastSample >= sampleTicks)
   {
-    worker->fetchMoreSamples();
-    askedForMore = true;
+    if (window != NULL && windowPos < window->count)
+    {
+      windowPos++;
+    }
+    lastSample = clock.now();
   }
-  if (elapsedTime - lastSampleTime >= 1.0 / sampleRate)
+  if ((window == NULL || windowPos >= window->count) && worker != NULL)
   {
-    if (!sampleQueue.empty())
+    SampleWindow *next = worker->swapWindow(window);
+    if (next != NULL)
     {
-      sampleQueue.pop_front();
+      window = next;
+      windowPos = 0;
+    }
+    else if (window != NULL && !worker->done())
+    {
+      underruns++;
     }
-    lastSampleTime = elapsedTime;
   }
-  output(0) = sampleQueue.empty() ? 0.0 : sampleQueue.front();
+  output(0) = (window == NULL || windowPos >= window->count) ? 
+    0.0 : window->samples[windowPos];
 }
 
 void SamplePlayer::update(SamplePlayer::update_flags_t flag)
@@ -210,12 +230,14 @@ void SamplePlayer::update(SamplePlayer::update_flags_t flag)
   	case INIT:
   	sampleRate = INITIAL_SAMPLE_RATE;
 	  setParameter(PARAM_SAMPLE_RATE, QString::number(sampleRate));
-	  lastSampleTime = elapsedTime = 0.0;
+	  sampleTicks = clock.ticks(1.0 / sampleRate);
+	  lastSample = 0;
+	  clock.restart();
 		break;
 		
   	case MODIFY:
 	  sampleRate = getParameter(PARAM_SAMPLE_RATE).toDouble();
-    sampleQueue.clear();
+	  sampleTicks = clock.ticks(1.0 / sampleRate);
 	  if (worker)
 	  {
   	  worker->bail();
@@ -223,11 +245,15 @@ void SamplePlayer::update(SamplePlayer::update_flags_t flag)
   	  delete worker;
   	  worker = NULL;
 	  }
+	  delete window;
+	  window = NULL;
+	  windowPos = 0;
+	  underruns = 0;
 	  worker = new SampleWorker(sampleFilename->text(), this);
 	  worker->start();
-	  worker->fetchMoreSamples();
 	  sampleFilename->blacken();
-    lastSampleTime = elapsedTime = 0.0;
+	  lastSample = 0;
+	  clock.restart();
 		break;
 		
   	case PAUSE:
@@ -235,7 +261,8 @@ void SamplePlayer::update(SamplePlayer::update_flags_t flag)
 		break;
 		
   	case PERIOD:
-		dt_s = RT::System::getInstance()->getPeriod() * 1e-9;
+		clock.update();
+		sampleTicks = clock.ticks(1.0 / sampleRate);
 		break;
 		
 		case EXIT:
@@ -444,19 +471,3 @@ void SamplePlayer::receiveEvent(const Event::Object *event)
 	}
 }
 
-void SamplePlayer::customEvent(QCustomEvent *e)
-{
-  if (e->type() != JobDoneEvent::code)
-  {
-    return;
-  }
-  // Ensure that the realtime thread isn't in the middle of executing 
-	// DefaultGUIModel::execute()
-	SyncEvent event;
-	RT::System::getInstance()->postEvent(&event);
-  for (size_t i = 0; i < worker->samples.size(); i++)
-  {
-    sampleQueue.push_back(worker->samples[i]);
-  }
-  askedForMore = false;
-}
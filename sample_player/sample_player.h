@@ -1,7 +1,9 @@
 /*
  * Read samples from a file at some rate.
- * IO is done by a worker thread. The Player asks for more samples when it gets 
- * low, and when the worker is ready the new samples are copied in.
+ * IO is done by a worker thread. It maps the file a window at a time, keeping 
+ * a few windows queued up, and the Player reads the samples right out of the 
+ * mapping. When the Player moves on to a new window, it hands the old one 
+ * back for the worker to unmap. Neither waits on the other or on the GUI.
  */
 
 #include <event.h>
@@ -9,10 +11,12 @@
 #include <rt.h>
 #include <default_gui_model.h>
 #include <workspace.h>
+#include "../common/exectime.h"
+#include "../common/timebase.h"
 
 class SampleWorker;
+struct SampleWindow;
 
-#include <deque>
 #include <map>
 
 #include <qobject.h>
@@ -60,7 +64,6 @@ public:
 	virtual ~SamplePlayer();
 	virtual void update(update_flags_t flag);
 	void execute();
-	virtual void customEvent(QCustomEvent *e);
 
 public slots:
 	/* DO NOT EDIT */
@@ -80,13 +83,16 @@ protected:
 	void setEvent(const QString &name, double &ref);
 
 private:
-  double dt_s;
-  double elapsedTime;
+  Timebase clock;
   double sampleRate;
-  double lastSampleTime;
-  std::deque<double> sampleQueue;
+  uint64_t sampleTicks;
+  uint64_t lastSample;
+  SampleWindow *window;
+  size_t windowPos;
   SampleWorker *worker;
-  bool askedForMore;
+  double underruns;
+
+  EXECTIME_DECLARE;
 
 	// QT components
 	DefaultGUILineEdit *sampleFilename;
@@ -113,10 +119,3 @@ private:
 private slots:
 	void setSampleFilename();
 };
-
-class JobDoneEvent : public QCustomEvent
-{
-public:
-  static int const code = 31812;
-  JobDoneEvent() : QCustomEvent(code) {}
-};
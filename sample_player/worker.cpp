@@ -7,21 +7,28 @@
 
 #include "sample_player.h"
 
-#include <qapplication.h>
-#include <qsemaphore.h>
-
 // Grab points in batches of three hundred thousand, a number scientifically 
 // determined by process of sounding right.
 #define WINDOW_SIZE (300000 * sizeof(double))
 
+// Touch one sample in every page this far apart, so the pages are read in 
+// here rather than faulted in by the realtime thread.
+#define PAGE_STRIDE 4096
+
+// Once fewer than LOW_WATERMARK windows are waiting for the player, map more 
+// until HIGH_WATERMARK are. Otherwise check back every POLL_MS.
+#define LOW_WATERMARK 1
+#define HIGH_WATERMARK 3
+#define POLL_MS 20
+
 namespace bio = boost::iostreams;
 namespace bfs = boost::filesystem;
 
 SampleWorker::SampleWorker(QString aFilename, SamplePlayer *aPlayer) :
-  advance(1), filename(aFilename), player(aPlayer), nextOffset(0), 
-  _bail(false)
+  filename(aFilename), player(aPlayer), nextOffset(0), 
+  _bail(false), _done(false)
 {
-  bfs::path filepath(aFilename.utf8(), bfs::native);
+  bfs::path filepath(aFilename.utf8().data());
   if (bfs::exists(filepath) && bfs::is_regular_file(filepath))
   {
     filesize = bfs::file_size(filepath);
@@ -34,53 +41,98 @@ SampleWorker::SampleWorker(QString aFilename, SamplePlayer *aPlayer) :
 
 SampleWorker::~SampleWorker()
 {
+  SampleWindow *window;
+  while (ready.pop(window))
+  {
+    delete window;
+  }
+  unmapRetired();
 }
 
-void SampleWorker::fetchMoreSamples()
+// Called by the realtime thread. Take the next window, if it's mapped yet, 
+// and hand back the |finished| one. Returns NULL (and keeps |finished|) 
+// when the worker hasn't caught up.
+SampleWindow *SampleWorker::swapWindow(SampleWindow *finished)
 {
-  advance--;
+  SampleWindow *next;
+  if (!ready.pop(next))
+  {
+    return NULL;
+  }
+  // There are never more windows about than retired can hold.
+  if (finished != NULL)
+  {
+    retired.push(finished);
+  }
+  return next;
+}
+
+// True once every window of the file has been handed to the player.
+bool SampleWorker::done() const
+{
+  return _done && ready.empty();
 }
 
 void SampleWorker::bail()
 {
   _bail = true;
-  advance--;
+}
+
+void SampleWorker::unmapRetired()
+{
+  SampleWindow *window;
+  while (retired.pop(window))
+  {
+    delete window;
+  }
 }
 
 void SampleWorker::run()
 {
   if (filesize == 0)
   {
+    _done = true;
     return;
   }
-  for (;;)
+  // Windows have to start on a multiple of the mapping alignment, so round 
+  // their size up to one. That's also a whole number of samples.
+  boost::intmax_t alignment = bio::mapped_file::alignment();
+  boost::intmax_t windowSize = 
+    (WINDOW_SIZE + alignment - 1) / alignment * alignment;
+  bool filling = true;
+  while (!_bail)
   {
-    advance++;
-    if (_bail)
+    unmapRetired();
+    if (ready.size() < LOW_WATERMARK)
     {
-      break;
+      filling = true;
     }
-    samples.clear();
-    if (sampleFile.is_open())
+    if (!filling || ready.size() >= HIGH_WATERMARK || 
+        nextOffset >= (boost::intmax_t)filesize)
     {
-      sampleFile.close();
+      filling = false;
+      msleep(POLL_MS);
+      continue;
     }
-    sampleFile.open(filename, 
-      std::ios_base::binary | std::ios_base::in, 
-      std::min(WINDOW_SIZE, filesize - nextOffset), 
+    
+    SampleWindow *window = new SampleWindow;
+    window->file.open(filename.utf8().data(), 
+      std::min((uintmax_t)windowSize, filesize - nextOffset), 
       nextOffset);
-    nextOffset += WINDOW_SIZE;
-    nextOffset -= (nextOffset % bio::mapped_file::alignment());
-    nextOffset += bio::mapped_file::alignment();
-    if (nextOffset >= (boost::intmax_t)filesize)
+    nextOffset += windowSize;
+    window->samples = (const double *)window->file.data();
+    window->count = window->file.size() / sizeof(double);
+    
+    volatile double sink = 0.0;
+    for (size_t i = 0; i < window->count; i += PAGE_STRIDE / sizeof(double))
     {
-      break;
+      sink += window->samples[i];
     }
-    double *unreadSamples = (double *)sampleFile.const_data();
-    for (size_t i = 0; i < sampleFile.size() / sizeof(double); i++)
+    
+    ready.push(window);
+    if (nextOffset >= (boost::intmax_t)filesize)
     {
-      samples.push_back(unreadSamples[i]);
+      _done = true;
     }
-    QApplication::postEvent(player, new JobDoneEvent());
   }
 }
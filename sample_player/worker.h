@@ -1,19 +1,29 @@
 /*
- * Grab samples from a file in chunks, on request.
+ * Map a file of samples a window at a time, keeping a few windows ahead of 
+ * the player.
  */
 
 #ifndef WORKER_H_X5J7EA96
 #define WORKER_H_X5J7EA96
 
 #include <stdint.h>
-#include <vector>
 
 #include <boost/iostreams/device/mapped_file.hpp>
 
+#include "../common/ringbuffer.h"
+
 class SamplePlayer;
 
 #include <qthread.h>
-class QSemaphore;
+
+// One mapped stretch of the sample file. The player reads samples straight 
+// out of the mapping, so nothing is copied.
+struct SampleWindow
+{
+  boost::iostreams::mapped_file_source file;
+  const double *samples;
+  size_t count;
+};
 
 class SampleWorker : public QThread
 {
@@ -21,18 +31,24 @@ public:
   SampleWorker(QString aFilename, SamplePlayer *aPlayer);
   virtual ~SampleWorker();
   virtual void run();
-  void fetchMoreSamples();
+  SampleWindow *swapWindow(SampleWindow *finished);
+  bool done() const;
   void bail();
-  std::vector<double> samples;
   
 private:
-  QSemaphore advance;
   QString filename;
   SamplePlayer *player;
   uintmax_t filesize;
-  boost::iostreams::mapped_file sampleFile;
   boost::intmax_t nextOffset;
-  bool _bail;
+  volatile bool _bail;
+  volatile bool _done;
+  
+  // Windows change hands through these without locking. The worker fills 
+  // ready, the player empties it; the player fills retired, the worker 
+  // empties it (unmapping isn't something to do in the realtime thread).
+  RingBuffer<SampleWindow *, 4> ready;
+  RingBuffer<SampleWindow *, 8> retired;
+  void unmapRetired();
 };
 
 #endif /* end of include guard: WORKER_H_X5J7EA96 */
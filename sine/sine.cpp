@@ -1,5 +1,6 @@
 #include <math.h>
 #include <sine.h>
+#include <fstream>
 
 extern "C" Plugin::Object *createRTXIPlugin(void) {
     return new Sine();
@@ -7,6 +8,31 @@ extern "C" Plugin::Object *createRTXIPlugin(void) {
 
 const char *PARAM_AMPLITUDE = "Amplitude (V)";
 const char *PARAM_FREQUENCY = "Frequency (Hz)";
+const char *PARAM_WAVEFORM = "Waveform";
+const char *COMMENT_WAVEFORM_FILE = "Waveform file";
+const char *PARAM_SWEEP = "Sweep";
+const char *PARAM_START_FREQUENCY = "Start frequency (Hz)";
+const char *PARAM_STOP_FREQUENCY = "Stop frequency (Hz)";
+const char *PARAM_SWEEP_DURATION = "Sweep duration (s)";
+const char *PARAM_REPEAT_SWEEP = "Repeat sweep";
+
+static const double TWO_TO_THE_64 = 18446744073709551616.0;
+// Just under half a cycle per tick, the most an int64_t increment can hold.
+static const double MAX_INCREMENT = TWO_TO_THE_64 * 0.5 * (1.0 - 1e-9);
+
+enum waveform_t {
+    WAVEFORM_SINE,
+    WAVEFORM_SAWTOOTH,
+    WAVEFORM_TRIANGLE,
+    WAVEFORM_SQUARE,
+    WAVEFORM_FILE,
+};
+
+enum sweep_t {
+    SWEEP_NONE,
+    SWEEP_LINEAR,
+    SWEEP_LOG,
+};
 
 static DefaultGUIModel::variable_t vars[] = {
     {
@@ -24,6 +50,46 @@ static DefaultGUIModel::variable_t vars[] = {
         "Number of waves in a second",
         DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
     },
+    {
+        PARAM_WAVEFORM,
+        "0 for sine, 1 for sawtooth, 2 for triangle, 3 for square, 4 for one "
+        "cycle read from the waveform file",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+    },
+    {
+        COMMENT_WAVEFORM_FILE,
+        "Text file of samples making up one cycle, for waveform 4. It's "
+        "stretched to the frequency and scaled by the amplitude",
+        DefaultGUIModel::COMMENT,
+    },
+    {
+        PARAM_SWEEP,
+        "0 for a steady frequency, 1 to sweep linearly from the start to the "
+        "stop frequency, 2 to sweep logarithmically (the same time per octave)",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+    },
+    {
+        PARAM_START_FREQUENCY,
+        "Frequency at the start of a sweep",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+    },
+    {
+        PARAM_STOP_FREQUENCY,
+        "Frequency at the end of a sweep",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+    },
+    {
+        PARAM_SWEEP_DURATION,
+        "How long a sweep takes (s)",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+    },
+    {
+        PARAM_REPEAT_SWEEP,
+        "1 to start the sweep over when it ends, 0 to stay at the stop "
+        "frequency",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+    },
+    EXECTIME_VARS
 };
 
 static size_t num_vars = sizeof(vars)/sizeof(DefaultGUIModel::variable_t);
@@ -31,10 +97,20 @@ static size_t num_vars = sizeof(vars)/sizeof(DefaultGUIModel::variable_t);
 Sine::Sine(void)
     : DefaultGUIModel("Sine",::vars,::num_vars) {
 
-    t = 0;
+    phase = 0;
     amplitude = 1.0; setParameter(PARAM_AMPLITUDE, amplitude);
     frequency = 1.0; setParameter(PARAM_FREQUENCY, frequency);
+    waveform = WAVEFORM_SINE; setParameter(PARAM_WAVEFORM, waveform);
+    sweep = SWEEP_NONE; setParameter(PARAM_SWEEP, sweep);
+    startFrequency = 1.0; setParameter(PARAM_START_FREQUENCY, startFrequency);
+    stopFrequency = 100.0; setParameter(PARAM_STOP_FREQUENCY, stopFrequency);
+    sweepDuration = 10.0; setParameter(PARAM_SWEEP_DURATION, sweepDuration);
+    repeatSweep = false; setParameter(PARAM_REPEAT_SWEEP, repeatSweep);
+    sweeping = false;
     period = RT::System::getInstance()->getPeriod()*1e-9;
+    buildWave();
+    startSweep();
+    EXECTIME_INIT;
 
     refresh();
 }
@@ -42,18 +118,164 @@ Sine::Sine(void)
 Sine::~Sine(void) {}
 
 void Sine::execute(void) {
-    t += period;
-    output(0) = sin(t * frequency * 2.0 * M_PI) * amplitude;
+    EXECTIME_SCOPE;
+    phase += increment;
+    output(0) = Wavetable::lookup(table, phase) * amplitude;
+
+    if (sweeping) {
+        sweepIncrement = sweepIncrement * sweepRatio + sweepStep;
+        if (--sweepTicksLeft == 0) {
+            if (repeatSweep) {
+                sweepIncrement = startIncrement;
+                sweepTicksLeft = sweepTicks;
+            } else {
+                sweeping = false;
+            }
+        }
+        // Rounding builds up over a long sweep, so keep it in range here too.
+        if (fabs(sweepIncrement) > MAX_INCREMENT)
+            sweepIncrement = sweepIncrement > 0.0 ? MAX_INCREMENT
+                                                  : -MAX_INCREMENT;
+        increment = (int64_t)sweepIncrement;
+        table = wave.table(increment);
+    }
+}
+
+// Set the increment for a steady frequency, or start a sweep over.
+void Sine::startSweep(void) {
+    setSweepRates();
+    sweeping = sweep != SWEEP_NONE && sweepTicks > 0;
+    double f = sweeping ? startFrequency : frequency;
+    sweepIncrement = sweeping ? startIncrement : f * period * TWO_TO_THE_64;
+    sweepTicksLeft = sweepTicks;
+    increment = (int64_t)llrint(sweepIncrement);
+    table = wave.table(increment);
+}
+
+// The sweep's length and per-tick changes for the current period. A 
+// logarithmic sweep needs both ends above zero; otherwise it's linear.
+void Sine::setSweepRates(void) {
+    sweepTicks = (uint64_t)(sweepDuration / period + 0.5);
+    // Cycles per tick, as a fraction of 2^64.
+    startIncrement = startFrequency * period * TWO_TO_THE_64;
+    if (sweep == SWEEP_LOG && startFrequency > 0.0 && stopFrequency > 0.0) {
+        sweepRatio = pow(stopFrequency / startFrequency, 1.0 / sweepTicks);
+        sweepStep = 0.0;
+    } else {
+        sweepRatio = 1.0;
+        sweepStep = (stopFrequency - startFrequency) * period * 
+                    TWO_TO_THE_64 / sweepTicks;
+    }
+}
+
+// A new period changes how much phase every tick is worth. Keep the same 
+// frequency, and carry a sweep on from where it's got to, with its remaining
+// time in the new ticks, rather than starting it over.
+void Sine::changePeriod(double newPeriod) {
+    double scale = newPeriod / period;
+    period = newPeriod;
+    setSweepRates();
+    if (sweeping) {
+        sweepIncrement *= scale;
+        sweepTicksLeft = (uint64_t)(sweepTicksLeft / scale + 0.5);
+        if (sweepTicksLeft == 0)
+            sweepTicksLeft = 1;
+    } else {
+        sweepIncrement = increment * scale;
+    }
+    if (fabs(sweepIncrement) > MAX_INCREMENT)
+        sweepIncrement = sweepIncrement > 0.0 ? MAX_INCREMENT : -MAX_INCREMENT;
+    increment = (int64_t)llrint(sweepIncrement);
+    table = wave.table(increment);
+}
+
+// Frequencies have to stay under the Nyquist frequency, both because they'd
+// only alias above it and because their increment wouldn't fit. Show the 
+// user what we did instead, as Square does with its period.
+void Sine::clampFrequency(const char *name, double &f) {
+    double highest = MAX_INCREMENT / (period * TWO_TO_THE_64);
+    if (fabs(f) > highest) {
+        f = f > 0.0 ? highest : -highest;
+        setParameter(name, f);
+    }
+}
+
+// Work out the harmonics of the chosen waveform and build its tables. All of 
+// them start at zero and rise, like sine.
+void Sine::buildWave(void) {
+    std::vector<std::complex<double> > harmonics(WAVETABLE_SIZE / 2);
+    // A harmonic of sin(2 pi k t) is -i.
+    const std::complex<double> sine(0.0, -1.0);
+    size_t k;
+    switch (waveform) {
+        case WAVEFORM_SAWTOOTH:
+            for (k = 1; k < harmonics.size(); k++)
+                harmonics[k] = sine * ((k % 2 ? 2.0 : -2.0) / (M_PI * k));
+            break;
+        case WAVEFORM_TRIANGLE:
+            for (k = 1; k < harmonics.size(); k += 2)
+                harmonics[k] = sine * ((k % 4 == 1 ? 8.0 : -8.0) / 
+                                       (M_PI * M_PI * k * k));
+            break;
+        case WAVEFORM_SQUARE:
+            for (k = 1; k < harmonics.size(); k += 2)
+                harmonics[k] = sine * (4.0 / (M_PI * k));
+            break;
+        case WAVEFORM_FILE: {
+            // A plain DFT, since the file can be any length. Each harmonic's 
+            // twiddle factor is turned one step per sample, not recomputed.
+            std::vector<double> samples;
+            std::ifstream in(waveformFile.latin1());
+            double x;
+            while (in >> x)
+                samples.push_back(x);
+            size_t n = samples.size();
+            if (n == 0)
+                break;
+            harmonics.resize(std::min(harmonics.size(), n / 2 + 1));
+            for (k = 0; k < harmonics.size(); k++) {
+                std::complex<double> step = std::polar(1.0, -2.0 * M_PI * k / n);
+                std::complex<double> w = 1.0, sum = 0.0;
+                for (size_t i = 0; i < n; i++) {
+                    sum += samples[i] * w;
+                    w *= step;
+                }
+                harmonics[k] = sum * ((k == 0 || 2 * k == n ? 1.0 : 2.0) / n);
+            }
+            break;
+        }
+        default:
+            harmonics[1] = sine;
+            break;
+    }
+    wave.build(harmonics);
 }
 
 void Sine::update(DefaultGUIModel::update_flags_t flag) {
+    // Changes carry on from the current phase, so the wave doesn't jump.
     if(flag == MODIFY) {
         amplitude = getParameter(PARAM_AMPLITUDE).toDouble();
         frequency = getParameter(PARAM_FREQUENCY).toDouble();
+        clampFrequency(PARAM_FREQUENCY, frequency);
+        sweep = getParameter(PARAM_SWEEP).toUInt();
+        startFrequency = getParameter(PARAM_START_FREQUENCY).toDouble();
+        clampFrequency(PARAM_START_FREQUENCY, startFrequency);
+        stopFrequency = getParameter(PARAM_STOP_FREQUENCY).toDouble();
+        clampFrequency(PARAM_STOP_FREQUENCY, stopFrequency);
+        sweepDuration = getParameter(PARAM_SWEEP_DURATION).toDouble();
+        repeatSweep = getParameter(PARAM_REPEAT_SWEEP).toUInt();
+        unsigned int newWaveform = getParameter(PARAM_WAVEFORM).toUInt();
+        QString newFile = getComment(COMMENT_WAVEFORM_FILE);
+        if (newWaveform != waveform || 
+            (newWaveform == WAVEFORM_FILE && newFile != waveformFile)) {
+            waveform = newWaveform;
+            waveformFile = newFile;
+            buildWave();
+        }
+        startSweep();
     } else if(flag == PERIOD) {
-        period = RT::System::getInstance()->getPeriod()*1e-9;
+        changePeriod(RT::System::getInstance()->getPeriod()*1e-9);
     } else if (flag == PAUSE) {
         output(0) = 0;
     }
 }
-
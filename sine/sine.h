@@ -1,4 +1,6 @@
 #include <default_gui_model.h>
+#include "../common/exectime.h"
+#include "wavetable.h"
 
 class Sine : public DefaultGUIModel
 {
@@ -16,9 +18,42 @@ protected:
 
 private:
 
-    double t;
+    void buildWave(void);
+    void startSweep(void);
+    void setSweepRates(void);
+    void changePeriod(double newPeriod);
+    void clampFrequency(const char *name, double &f);
+
     double period;
     double amplitude;
     double frequency;
 
+    // Phase in 2^64ths of a cycle; see wavetable.h.
+    uint64_t phase;
+    int64_t increment;
+    Wavetable wave;
+    const double *table;
+
+    // Sweeps change the increment every tick, multiplying by |sweepRatio| 
+    // (logarithmic) or adding |sweepStep| (linear), so the frequency is 
+    // integrated into the phase and never jumps.
+    unsigned int sweep;
+    double startFrequency;
+    double stopFrequency;
+    double sweepDuration;
+    bool repeatSweep;
+    bool sweeping;
+    double sweepIncrement;
+    double startIncrement;
+    double sweepRatio;
+    double sweepStep;
+    uint64_t sweepTicks;
+    uint64_t sweepTicksLeft;
+
+    // What the tables were last built from, so other changes don't rebuild.
+    unsigned int waveform;
+    QString waveformFile;
+
+    EXECTIME_DECLARE;
+
 };
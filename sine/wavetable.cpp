@@ -0,0 +1,32 @@
+#include "wavetable.h"
+
+#include "../realfir/fft.h"
+
+Wavetable::Wavetable() : tables(WAVETABLE_LEVELS * ROW, 0.0)
+{
+}
+
+void Wavetable::build(const vector<complex<double> > &harmonics)
+{
+  FFT fft(WAVETABLE_SIZE);
+  vector<complex<double> > spectrum(WAVETABLE_SIZE);
+  for (size_t level = 0; level < WAVETABLE_LEVELS; level++) {
+    // A real wave: each harmonic is split between its positive and negative 
+    // frequency bins.
+    size_t highest = (WAVETABLE_SIZE / 2) >> level;
+    if (level == 0)
+      highest--;
+    spectrum.assign(WAVETABLE_SIZE, 0.0);
+    if (!harmonics.empty())
+      spectrum[0] = harmonics[0].real();
+    for (size_t k = 1; k <= highest && k < harmonics.size(); k++) {
+      spectrum[k] = harmonics[k] / 2.0;
+      spectrum[WAVETABLE_SIZE - k] = conj(harmonics[k]) / 2.0;
+    }
+    fft.inverse(&spectrum[0]);
+
+    double *row = &tables[level * ROW];
+    for (size_t i = 0; i < ROW; i++)
+      row[i] = spectrum[(i + WAVETABLE_SIZE - 1) % WAVETABLE_SIZE].real();
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ * Wavetable
+ * One cycle of a periodic wave, band-limited for every playback rate.
+ */
+
+/*
+ * A direct digital synthesizer keeps its phase in a 64-bit integer, which 
+ * wraps around once per cycle all by itself and never loses precision. The 
+ * top WAVETABLE_BITS pick a table entry and the rest interpolate between 
+ * entries.
+ *
+ * Played fast, a table full of harmonics would alias, so there's one table 
+ * per octave of playback rate ("mipmaps"), each with only the harmonics that 
+ * stay under the Nyquist frequency at that rate.
+ */
+
+#ifndef WAVETABLE_H
+#define WAVETABLE_H
+
+#include <complex>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+#define WAVETABLE_BITS 11
+#define WAVETABLE_SIZE (1 << WAVETABLE_BITS)
+// Table |l| keeps harmonics up to WAVETABLE_SIZE / 2 >> l, down to the 
+// fundamental alone.
+#define WAVETABLE_LEVELS WAVETABLE_BITS
+
+class Wavetable
+{
+public:
+  Wavetable();
+
+  // Build every table from one cycle's harmonics, where the wave is the sum 
+  // over k of Re(harmonics[k] * exp(2 pi i k t)), t in cycles. Any harmonics 
+  // beyond what the first table holds are dropped.
+  void build(const vector<complex<double> > &harmonics);
+
+  // The table to play with a phase step of |increment| per tick (a cycle 
+  // being 2^64), without aliasing.
+  const double *table(int64_t increment) const
+  {
+    uint64_t step = increment < 0 ? -(uint64_t)increment : increment;
+    int level = step ? WAVETABLE_BITS - __builtin_clzll(step) : 0;
+    if (level < 0)
+      level = 0;
+    if (level > WAVETABLE_LEVELS - 1)
+      level = WAVETABLE_LEVELS - 1;
+    return &tables[level * ROW + 1];
+  }
+
+  // The wave at |phase|, by cubic (4-point Lagrange) interpolation.
+  static double lookup(const double *table, uint64_t phase)
+  {
+    const double *p = table + (phase >> (64 - WAVETABLE_BITS)) - 1;
+    double f = (double)((phase << WAVETABLE_BITS) >> 11) * 
+               (1.0 / 9007199254740992.0);
+    double c1 = p[2] - p[0] * (1.0 / 3.0) - p[1] * 0.5 - p[3] * (1.0 / 6.0);
+    double c2 = (p[0] + p[2]) * 0.5 - p[1];
+    double c3 = (p[3] - p[0]) * (1.0 / 6.0) + (p[1] - p[2]) * 0.5;
+    return ((c3 * f + c2) * f + c1) * f + p[1];
+  }
+
+private:
+  // Each row is one table with an entry before and two after it, copied 
+  // from the other end, so lookups never wrap.
+  enum { ROW = WAVETABLE_SIZE + 3 };
+  vector<double> tables;
+};
+
+#endif /* end of include guard: WAVETABLE_H */
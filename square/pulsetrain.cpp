@@ -0,0 +1,165 @@
+#include "pulsetrain.h"
+
+#define FRACTION_MASK (((uint64_t)1 << TIMEBASE_FRACTION_BITS) - 1)
+
+// The residual tables have 2^BLEP_BITS steps between ticks.
+#define BLEP_BITS 8
+#define BLEP_SIZE (1 << BLEP_BITS)
+#define BLEP_SHIFT (TIMEBASE_FRACTION_BITS - BLEP_BITS)
+
+namespace
+{
+
+// The difference between a band-limited step and a plain one, on the ticks
+// either side of an edge, by how far past the earlier tick the edge falls
+// (the fractional part of its time). A step of one comes out as 0 + before
+// and then 1 + after, and the two halves of the step meet in the middle.
+struct BlepTable
+{
+  // An extra entry at the end, for interpolation from the last one.
+  double before[BLEP_SIZE + 2];
+  double after[BLEP_SIZE + 2];
+
+  BlepTable()
+  {
+    for (size_t i = 0; i < BLEP_SIZE + 2; i++) {
+      double u = (double)i / BLEP_SIZE;
+      before[i] = (1.0 - u) * (1.0 - u) / 2.0;
+      after[i] = -u * u / 2.0;
+    }
+  }
+
+  // An edge right on a tick counts as a whole tick past the one before.
+  static double lookup(const double *table, uint64_t fraction)
+  {
+    if (fraction == 0)
+      fraction = (uint64_t)1 << TIMEBASE_FRACTION_BITS;
+    size_t i = fraction >> BLEP_SHIFT;
+    double f = (double)(fraction & ((1 << BLEP_SHIFT) - 1)) * 
+               (1.0 / (1 << BLEP_SHIFT));
+    return table[i] + f * (table[i + 1] - table[i]);
+  }
+};
+
+const BlepTable blep;
+
+}
+
+PulseTrain::PulseTrain() : rest(0.0), cursor(0), edgeWhole(0),
+  edgeFraction(0), edge(0), burstsLeft(0), finished(true), level(0.0)
+{
+}
+
+void PulseTrain::compile(const Timebase &clock, double period, double duty,
+                         size_t pulses, double gap, bool alternate,
+                         double low, double high)
+{
+  if (duty < 0.0)
+    duty = 0.0;
+  if (duty > 1.0)
+    duty = 1.0;
+  // The low part is whatever's left, so the pulses add up to exactly the
+  // period.
+  uint64_t periodTicks = clock.fineTicks(period);
+  uint64_t highTicks = clock.fineTicks(period * duty);
+  if (highTicks > periodTicks)
+    highTicks = periodTicks;
+  uint64_t gapTicks = clock.fineTicks(gap);
+
+  // With alternation and an odd number of pulses, the next burst starts
+  // the other way up, so the table holds two bursts.
+  size_t burst = pulses == 0 ? 1 : pulses;
+  size_t copies = alternate && burst % 2 == 1 ? 2 : 1;
+  segments.clear();
+  segments.reserve(2 * burst * copies);
+  bool inverted = false;
+  for (size_t c = 0; c < copies; c++) {
+    for (size_t p = 0; p < burst; p++) {
+      PulseSegment on = { highTicks, inverted ? 2 * low - high : high, false };
+      PulseSegment off = { periodTicks - highTicks, low, false };
+      if (p == burst - 1) {
+        off.length += gapTicks;
+        off.endsBurst = pulses != 0;
+      }
+      segments.push_back(on);
+      segments.push_back(off);
+      if (alternate)
+        inverted = !inverted;
+    }
+  }
+  rest = low;
+  if (cursor >= segments.size())
+    cursor = 0;
+}
+
+void PulseTrain::restart(uint64_t now, uint64_t bursts)
+{
+  cursor = 0;
+  edgeWhole = edge = now + 1;
+  edgeFraction = 0;
+  burstsLeft = bursts;
+  finished = segments.empty();
+  level = rest;
+}
+
+void PulseTrain::step()
+{
+  const PulseSegment &s = segments[cursor];
+  level = s.level;
+  uint64_t fraction = edgeFraction + (s.length & FRACTION_MASK);
+  edgeWhole += (s.length >> TIMEBASE_FRACTION_BITS) +
+               (fraction >> TIMEBASE_FRACTION_BITS);
+  edgeFraction = fraction & FRACTION_MASK;
+  edge = edgeWhole + (edgeFraction != 0);
+  if (++cursor == segments.size())
+    cursor = 0;
+  // A burst always ends at rest, so the last one can stop right here.
+  if (s.endsBurst && burstsLeft != 0 && --burstsLeft == 0)
+    finished = true;
+}
+
+double PulseTrain::smoothEdge(uint64_t now)
+{
+  // The level's already stepped at any edges since the last tick, so take 
+  // back part of each step.
+  double correction = 0.0;
+  while (now >= edge && !finished) {
+    uint64_t fraction = edgeFraction;
+    bool justNow = now == edge;
+    double from = level;
+    step();
+    if (justNow)
+      correction += (level - from) * BlepTable::lookup(blep.after, fraction);
+  }
+  // And get a head start on any edges before the next tick.
+  if (edge == now + 1 && !finished)
+    correction += residualBefore(now);
+  return level + correction;
+}
+
+// Walk a copy of the cursor over the edges between |now| and the next tick.
+double PulseTrain::residualBefore(uint64_t now) const
+{
+  double correction = 0.0;
+  double from = level;
+  size_t next = cursor;
+  uint64_t whole = edgeWhole;
+  uint64_t fraction = edgeFraction;
+  uint64_t left = burstsLeft;
+  for (;;) {
+    const PulseSegment &s = segments[next];
+    correction += (s.level - from) * BlepTable::lookup(blep.before, fraction);
+    from = s.level;
+    if (s.endsBurst && left != 0 && --left == 0)
+      break;
+    uint64_t f = fraction + (s.length & FRACTION_MASK);
+    whole += (s.length >> TIMEBASE_FRACTION_BITS) + 
+             (f >> TIMEBASE_FRACTION_BITS);
+    fraction = f & FRACTION_MASK;
+    if (whole + (fraction != 0) != now + 1)
+      break;
+    if (++next == segments.size())
+      next = 0;
+  }
+  return correction;
+}
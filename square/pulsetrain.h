@@ -0,0 +1,93 @@
+/*
+ * PulseTrain
+ * Bursts of rectangular pulses, played from a table of segments.
+ */
+
+/*
+ * Everything about the train's shape (pulse width, pulses per burst, the gap
+ * between bursts, which way each pulse goes) is worked out once, in
+ * compile(), into a list of constant-voltage segments. Playing it is then
+ * only a matter of moving to the next segment when its time is up, so a
+ * complicated train costs the same per tick as a plain square wave.
+ *
+ * Segment lengths are fixed-point ticks (see Timebase::fineTicks), so a
+ * period that isn't a whole number of ticks is still exact on average. Each
+ * edge shows up on the first tick at or after the time it's due.
+ *
+ * That rounding is a jitter of up to a tick, which aliases: the spectrum
+ * fills with tones that aren't harmonics of the train. smoothAt() instead
+ * spreads each step over the tick before and the tick after it, weighted by
+ * where between them the edge really falls (a polynomial band-limited step,
+ * or PolyBLEP). The train is known ahead of time, so there's no delay.
+ */
+
+#ifndef PULSETRAIN_H
+#define PULSETRAIN_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "../common/timebase.h"
+
+struct PulseSegment
+{
+  // In fixed-point ticks.
+  uint64_t length;
+  double level;
+  // The last segment of a burst.
+  bool endsBurst;
+};
+
+class PulseTrain
+{
+public:
+  PulseTrain();
+
+  // Lay out the segments: |pulses| pulses (zero for an endless burst) of
+  // |period| seconds, each at |high| for |duty| of the period and then at
+  // |low|, with |gap| more seconds at |low| after each burst. If |alternate|,
+  // every other pulse goes as far below |low| as the rest go above.
+  void compile(const Timebase &clock, double period, double duty,
+               size_t pulses, double gap, bool alternate,
+               double low, double high);
+
+  // Start from the first segment on the tick after |now|, and stop after
+  // |bursts| bursts (zero for never).
+  void restart(uint64_t now, uint64_t bursts);
+
+  // The level at tick |now|. Ticks must come in order.
+  double at(uint64_t now)
+  {
+    while (now >= edge && !finished)
+      step();
+    return level;
+  }
+
+  // The same, band-limited. Away from the edges this is as cheap as at().
+  double smoothAt(uint64_t now)
+  {
+    if (finished || edge > now + 1)
+      return level;
+    return smoothEdge(now);
+  }
+
+private:
+  std::vector<PulseSegment> segments;
+  double rest;
+
+  // The segment that starts at the next edge, and that edge's time: whole
+  // ticks, then the fraction. |edge| is the first tick that sees it.
+  size_t cursor;
+  uint64_t edgeWhole;
+  uint64_t edgeFraction;
+  uint64_t edge;
+  uint64_t burstsLeft;
+  bool finished;
+  double level;
+
+  void step();
+  double smoothEdge(uint64_t now);
+  double residualBefore(uint64_t now) const;
+};
+
+#endif /* end of include guard: PULSETRAIN_H */
@@ -1,6 +1,6 @@
 // Square is an RTXI plugin that emits a square wave over its sole output. It
-// has parameters for the low and high voltage, as well as the period between 
-// changes.
+// has parameters for the low and high voltage, the period and duty cycle, and
+// for grouping pulses into bursts.
 //
 // This plugin is based off of some example plugins for RTXI, hence this long 
 // copyright and license notice.
@@ -74,9 +74,44 @@ static DefaultGUIModel::variable_t vars[] = {
         // I like to put units right in the parameter's name. It makes the name 
         // a bit longer but making the units obvious is worth it.
         "Period (ms)",
-        "How often to switch between 0 and Vmax (ms)",
+        "Time from the start of one pulse to the start of the next (ms)",
         DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
     },
+    {
+        "Duty cycle (%)",
+        "How much of each period to spend at Vmax (%)",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+    },
+    {
+        "Pulses per burst",
+        "How many pulses to group together (0 for one endless burst)",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+    },
+    {
+        "Burst interval (ms)",
+        "Extra time at Vmin after the last pulse of each burst (ms)",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
+    },
+    {
+        "Bursts",
+        "How many bursts to play before staying at Vmin (0 for no end)",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+    },
+    {
+        "Alternate polarity",
+        "When 1, every other pulse goes as far below Vmin as Vmax is above it",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+    },
+    {
+        "Band-limited",
+        "When 1, smooth each edge over the ticks either side of it, so edges "
+        "between ticks don't alias",
+        DefaultGUIModel::PARAMETER | DefaultGUIModel::UINTEGER,
+    },
+
+    // With `make EXECTIME=1`, three more states report how long `execute`
+    // takes. Otherwise this adds nothing.
+    EXECTIME_VARS
 };
 
 // Boilerplate.
@@ -93,15 +128,21 @@ PLUGIN_NAME::PLUGIN_NAME(void)
     // above.
     Vmin     =  0.0;  setParameter("Vmin", Vmin);
     Vmax     =  1.0;  setParameter("Vmax", Vmax);
-    period   = 50.0;  setParameter("Period (ms)", period);
-    age      =  0.0;
-    lastFlip =  0.0;
-    high     = false;
+    period   = 100.0; setParameter("Period (ms)", period);
+    duty     = 0.5;   setParameter("Duty cycle (%)", duty * 100.0);
+    pulses   = 0;     setParameter("Pulses per burst", pulses);
+    gap      = 0.0;   setParameter("Burst interval (ms)", gap);
+    bursts   = 0;     setParameter("Bursts", bursts);
+    alternate = false; setParameter("Alternate polarity", alternate);
+    bandLimited = false; setParameter("Band-limited", bandLimited);
     
     // Normally `update` is invoked by RTXI when an important event happens. I 
-    // call it here to initialize the `dt` variable.
+    // call it here to lay out the pulse train.
     update(PERIOD);
 
+    // Hook up the optional execute() timing states, if built in.
+    EXECTIME_INIT;
+
     // `refresh` updates the user interface. This is the only time you need to
     // call it.
     refresh();
@@ -115,21 +156,23 @@ PLUGIN_NAME::~PLUGIN_NAME(void) {}
 // code tight, as it can run very frequently. The RTXI guys recommend you do 
 // not instantiate variables here; use instance variables or static variables.
 void PLUGIN_NAME::execute(void) {
+
+    // Times this call, if built with `make EXECTIME=1`.
+    EXECTIME_SCOPE;
     
-    // We're one period older. Flip the voltage if we've been at the current
-    // voltage for long enough.
-    age += dt;
-    if (age - lastFlip >= period) {
-        high = !high;
-        lastFlip += period;
-    }
+    // We're one period older. The train moves on to its next segment if the
+    // current one is over. This is all integer arithmetic, so the edges land 
+    // on exactly the same ticks however long we run.
+    clock.tick();
     
-    // Sets this plugin's first output to the high or low voltage as indicated 
-    // by `high`. Plugins connected to this one in RTXI will immediately see 
-    // and use this new value.
+    // Sets this plugin's first output to the train's voltage right now. 
+    // Plugins connected to this one in RTXI will immediately see and use this
+    // new value.
     // Set this every step, even if it appears unchanged, in case we've just
     // been unpaused.
-    output(0) = high ? Vmax : Vmin;
+    // Band-limiting only costs anything on the ticks next to an edge.
+    output(0) = bandLimited ? train.smoothAt(clock.now()) 
+                            : train.at(clock.now());
 }
 
 // RTXI tells your plugin about certain interesting happenings.
@@ -155,14 +198,20 @@ void PLUGIN_NAME::update(DefaultGUIModel::update_flags_t flag) {
             newVmin = getParameter("Vmin").toDouble();
             newVmax = getParameter("Vmax").toDouble();
             period  = getParameter("Period (ms)").toDouble();
+            duty    = getParameter("Duty cycle (%)").toDouble() / 100.0;
+            pulses  = getParameter("Pulses per burst").toUInt();
+            gap     = getParameter("Burst interval (ms)").toDouble();
+            bursts  = getParameter("Bursts").toUInt();
+            alternate = getParameter("Alternate polarity").toUInt() != 0;
+            bandLimited = getParameter("Band-limited").toUInt() != 0;
             
             // Validate the setting for period given by the user. If the desired 
             // period is less than the current real-time period for RTXI, odd 
             // things will happen, so we set the real-time period as a minimum.
             // Also update the graphical interface so the user knows what we 
             // did.
-            if (period < dt) {
-                period = dt;
+            if (period < clock.period() * 1e3) {
+                period = clock.period() * 1e3;
                 setParameter("Period (ms)", period);
             }
             
@@ -174,9 +223,11 @@ void PLUGIN_NAME::update(DefaultGUIModel::update_flags_t flag) {
                 setParameter("Vmax", Vmax);
             } else {
                 Vmin = newVmin;
-                Vmin = newVmax;
+                Vmax = newVmax;
             }
             
+            // Work out the new train and start it from the top.
+            restartTrain();
             break;
         
         // When someone presses the Pause button on your plugin's window in 
@@ -187,12 +238,22 @@ void PLUGIN_NAME::update(DefaultGUIModel::update_flags_t flag) {
             break;
         
         // If the real-time period changes, this is how your plugin finds out.
-        // We'll save the new value, converted to milliseconds.
+        // The same train is now a different number of ticks, so lay it out 
+        // again.
         case PERIOD:
-            dt = RT::System::getInstance()->getPeriod() * 1e-6;
+            clock.update();
+            restartTrain();
             break;
         
         default:
             break;
     }
 }
+
+// All the thinking about the train's shape happens here, outside `execute`.
+// Lengths are converted from milliseconds to seconds on the way in.
+void PLUGIN_NAME::restartTrain(void) {
+    train.compile(clock, period * 1e-3, duty, pulses, gap * 1e-3, alternate,
+                  Vmin, Vmax);
+    train.restart(clock.now(), bursts);
+}
@@ -1,6 +1,6 @@
 // Square is an RTXI plugin that emits a square wave over its sole output. It
-// has parameters for the low and high voltage, as well as the period between 
-// changes.
+// has parameters for the low and high voltage, the period and duty cycle, and
+// for grouping pulses into bursts.
 //
 // This plugin is based off of some example plugins for RTXI, hence this long 
 // copyright and license notice.
@@ -28,6 +28,15 @@
 // hassle than if you did it yourself.
 #include <default_gui_model.h>
 
+// Optional execute() timing; see common/exectime.h.
+#include "../common/exectime.h"
+
+// Counts realtime ticks; see common/timebase.h.
+#include "../common/timebase.h"
+
+// The pulses themselves.
+#include "pulsetrain.h"
+
 // You can set your plugin name here and it'll be copied into all the boring 
 // boilerplate places it's needed.
 #define PLUGIN_NAME Square
@@ -52,25 +61,36 @@ private:
 
     // Here's where you put the variables you want to keep track of.
 
-    // These first three are parameters that the user can set within RTXI.
-    // `Vmin` is the low voltage, `Vmax` is the high voltage, and `period` is 
-    // how often to switch between the two.
+    // These are parameters that the user can set within RTXI. `Vmin` is the 
+    // low voltage and `Vmax` the high voltage. Pulses start every `period`, 
+    // stay high for `duty` of it, and come `pulses` at a time with `gap` more
+    // at `Vmin` between bursts, for `bursts` bursts. Zero `pulses` or 
+    // `bursts` means keep going forever. If `alternate` is set, every other
+    // pulse goes below `Vmin` instead.
     double Vmin;
     double Vmax;
     double period;
+    double duty;
+    unsigned int pulses;
+    double gap;
+    unsigned int bursts;
+    bool alternate;
 
-    // Here we track the passage of time. `dt` is the real-time period in 
-    // milliseconds, while `age` is how long this plugin has run unpaused in its
-    // lifetime.
-    double dt;
-    double age;
+    // With `bandLimited` set, edges between ticks are smoothed over the ticks
+    // either side instead of jumping on the next one.
+    bool bandLimited;
 
-    // The last time we flipped voltage.
-    double lastFlip;
+    // Here we track the passage of time. `clock` counts the real-time 
+    // periods this plugin has run unpaused in its lifetime.
+    Timebase clock;
 
-    // `high` is `true` when we're emitting the high voltage value.
-    bool high;
+    // The whole train, worked out ahead of time; see pulsetrain.h.
+    PulseTrain train;
 
     // If you think it makes sense to put some helper functions in here, now's
-    // the time.
+    // the time. This one rebuilds the train and starts it over.
+    void restartTrain(void);
+
+    // Expands to nothing unless built with `make EXECTIME=1`.
+    EXECTIME_DECLARE;
 };
@@ -45,60 +45,43 @@ static DefaultGUIModel::variable_t vars[] =
     PARAM_VARIANCE_RATIO,
     "Ratio of variances, sinusoid over input (V^2)",
     DefaultGUIModel::PARAMETER | DefaultGUIModel::DOUBLE,
-  }
+  },
+  EXECTIME_VARS
 };
 
 static size_t num_vars = sizeof(vars) / sizeof(DefaultGUIModel::variable_t);
 
 
+// Carries the finished variance ratio to the GUI thread, once per sample time.
 class VariancerEvent : public QCustomEvent
 {
 public:
   static const int EventType = QEvent::User + 2349;
   
-  VariancerEvent(double sampleIn, double sampleOut) : 
-    QCustomEvent(EventType), _sampleIn(sampleIn), _sampleOut(sampleOut)
-  {
-    _calculateVariance = false;
-  }
-  
-  VariancerEvent(bool calculateVariance) :
-    QCustomEvent(EventType), _calculateVariance(calculateVariance)
+  VariancerEvent(double ratio) : 
+    QCustomEvent(EventType), _ratio(ratio)
   {}
   
-  double sampleIn();
-  double sampleOut();
-  bool calculateVariance();
+  double ratio();
   
 private:
-  double _sampleIn, _sampleOut;
-  bool _calculateVariance;
+  double _ratio;
 };
 
-double VariancerEvent::sampleIn()
-{
-  return _sampleIn;
-}
-
-double VariancerEvent::sampleOut()
-{
-  return _sampleOut;
-}
-
-bool VariancerEvent::calculateVariance()
+double VariancerEvent::ratio()
 {
-  return _calculateVariance;
+  return _ratio;
 }
 
 
 Variancer::Variancer(void)
   : DefaultGUIModel("Variancer", ::vars, ::num_vars), varianceCalculated(false)
 {
-  update(PERIOD);
   setParameter(PARAM_SINE_RATE, INITIAL_SINE_RATE);
   setParameter(PARAM_SAMPLE_TIME, INITIAL_SAMPLE_TIME);
   setParameter(PARAM_VARIANCE_RATIO, INITIAL_VARIANCE_RATIO);
   update(MODIFY);
+  EXECTIME_INIT;
 
   refresh();
 }
@@ -107,17 +90,33 @@ Variancer::~Variancer(void) {}
 
 void Variancer::execute(void)
 {
-  age += dt_s;
+  EXECTIME_SCOPE;
+  clock.tick();
   
-  if (age < sampleTime)
+  if (clock.now() < sampleTicks)
   {
-    sineOut = sin(2.0 * M_PI * sineRate * age);
-    QApplication::postEvent(this, new VariancerEvent(input(0), sineOut));
+    // From the tick count itself, so the phase never drifts.
+    sineOut = sin(sineStep * clock.now());
+    
+    // Update the running means and sums of squared deviations. This needs 
+    // no storage, however long the sample time.
+    double in = input(0);
+    sampleCount++;
+    double deltaIn = in - meanIn;
+    double deltaOut = sineOut - meanOut;
+    meanIn += deltaIn / sampleCount;
+    meanOut += deltaOut / sampleCount;
+    sumSquaresIn += deltaIn * (in - meanIn);
+    sumSquaresOut += deltaOut * (sineOut - meanOut);
+    
     output(0) = sineOut;
   }
   else if (!varianceCalculated)
   {
-    QApplication::postEvent(this, new VariancerEvent(true));
+    // Both variances share the same sample count, so it cancels out.
+    varianceCalculated = true;
+    double ratio = sumSquaresOut != 0.0 ? sumSquaresIn / sumSquaresOut : 0.0;
+    QApplication::postEvent(this, new VariancerEvent(ratio));
     output(0) = 0.0;
   }
   else
@@ -130,10 +129,12 @@ void Variancer::update(DefaultGUIModel::update_flags_t flag)
   {
     case MODIFY:
     sineRate = getParameter(PARAM_SINE_RATE).toDouble();
-    samplesIn.clear();
-    samplesOut.clear();
+    sampleCount = 0.0;
+    meanIn = meanOut = 0.0;
+    sumSquaresIn = sumSquaresOut = 0.0;
     sampleTime = getParameter(PARAM_SAMPLE_TIME).toDouble();
-    age = 0.0;
+    clock.restart();
+    update(PERIOD);
     varianceCalculated = false;
     break;
     
@@ -142,7 +143,9 @@ void Variancer::update(DefaultGUIModel::update_flags_t flag)
     break;
     
     case PERIOD:
-    dt_s = RT::System::getInstance()->getPeriod() * 1e-9;
+    clock.update();
+    sineStep = 2.0 * M_PI * sineRate * clock.period();
+    sampleTicks = clock.ticks(sampleTime);
     break;
     
     default:
@@ -156,33 +159,5 @@ void Variancer::customEvent(QCustomEvent *e)
     return;
   
   VariancerEvent *ve = (VariancerEvent *)e;
-  if (!ve->calculateVariance())
-  {
-    samplesIn.push_back(ve->sampleIn());
-    samplesOut.push_back(ve->sampleOut());
-  }
-  else
-  {
-    varianceCalculated = true;
-    double meanIn = 0;
-    double meanOut = 0;
-    for (size_t i = 0; i < samplesIn.size(); i++)
-    {
-      meanIn += samplesIn[i];
-      meanOut += samplesOut[i];
-    }
-    double varianceIn = 0;
-    double varianceOut = 0;
-    for (size_t i = 0; i < samplesIn.size(); i++)
-    {
-      varianceIn += pow(samplesIn[i] - meanIn, 2);
-      varianceOut += pow(samplesOut[i] - meanOut, 2);
-    }
-    varianceIn /= samplesIn.size();
-    varianceOut /= samplesOut.size();
-    if (varianceOut != 0.0)
-      setParameter(PARAM_VARIANCE_RATIO, varianceIn / varianceOut);
-    else
-      setParameter(PARAM_VARIANCE_RATIO, 0.0);
-  }
+  setParameter(PARAM_VARIANCE_RATIO, ve->ratio());
 }
@@ -2,7 +2,8 @@
 // Copyright 2011 Nolan Waite
 
 #include <default_gui_model.h>
-#include <vector>
+#include "../common/exectime.h"
+#include "../common/timebase.h"
 
 class QCustomEvent;
 
@@ -20,12 +21,18 @@ protected:
   void update(DefaultGUIModel::update_flags_t);
 
 private:
-  double dt_s;
-  double age;
+  Timebase clock;
   double sampleTime;
+  uint64_t sampleTicks;
   double sineRate;
+  double sineStep;
   double sineOut;
   
-  std::vector<double> samplesIn, samplesOut;
+  // Running statistics (Welford's method), kept in the realtime thread.
+  double sampleCount;
+  double meanIn, meanOut;
+  double sumSquaresIn, sumSquaresOut;
   bool varianceCalculated;
+
+  EXECTIME_DECLARE;
 };